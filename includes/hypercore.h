@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 09:13:38 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/31 10:51:24 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -31,9 +31,11 @@
  *
  * @file argsparser.h Command line argument parsing utilities
  * @file garbage.h Memory management and garbage collection system
+ * @file pool.h Size-class object pool and container allocator hook
  */
 #include "lib/argsparser.h"
 #include "lib/garbage.h"
+#include "lib/pool.h"
 
 /**
  * @brief Comparison Utilities
@@ -6,13 +6,14 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 19:53:06 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/31 10:38:08 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #ifndef AVL_TREE_H
 #define AVL_TREE_H
 
+#include <lib/pool.h>
 #include <stddef.h>
 
 /**
@@ -40,6 +41,7 @@ typedef struct {
 	size_t size;									 /**< Number of nodes in the tree */
 	size_t key_size;								 /**< Size of the key type in bytes */
 	int (*compare_func)(const void *, const void *); /**< Key comparison function */
+	Allocator allocator;							 /**< Source of nodes and keys (values use malloc) */
 } AVLTree;
 
 /**
@@ -52,6 +54,11 @@ typedef struct {
  */
 int avl_tree_init(AVLTree *tree, size_t key_size, int (*compare_func)(const void *, const void *));
 
+/**
+ * @brief Initialize a new AVL tree whose nodes and keys come from allocator
+ */
+int avl_tree_init_with_allocator(AVLTree *tree, size_t key_size, int (*compare_func)(const void *, const void *), Allocator allocator);
+
 /**
  * @brief Insert a new key-value pair into the tree
  *
@@ -6,13 +6,14 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/31 10:50:59 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/31 10:50:59 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #ifndef HASH_TABLE_H
 #define HASH_TABLE_H
 
+#include <lib/pool.h>
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -35,6 +36,7 @@ typedef struct {
 	size_t key_size;
 	unsigned int (*hash_func)(const void *key);
 	int (*compare_func)(const void *a, const void *b);
+	Allocator allocator; // Entries and keys (values use malloc)
 } HashTable;
 
 /**
@@ -48,6 +50,12 @@ typedef struct {
  */
 bool hash_table_init(HashTable *table, size_t initial_capacity, size_t key_size, unsigned int (*hash_func)(const void *key), int (*compare_func)(const void *a, const void *b));
 
+/**
+ * @brief Initialize a new hash table whose entries and keys come from allocator
+ * @return bool true on success, false on failure
+ */
+bool hash_table_init_with_allocator(HashTable *table, size_t initial_capacity, size_t key_size, unsigned int (*hash_func)(const void *key), int (*compare_func)(const void *a, const void *b), Allocator allocator);
+
 /**
  * @brief Insert a key-value pair into the hash table
  * @return bool true on success, false on failure
@@ -6,13 +6,14 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 12:32:34 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 12:34:01 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #ifndef LIST_H
 #define LIST_H
 
+#include <lib/pool.h>
 #include <stddef.h>
 
 /**
@@ -30,11 +31,13 @@ typedef struct ListNode {
  * @param head First node of the list
  * @param tail Last node of the list
  * @param size Current number of elements
+ * @param allocator Allocator for the nodes (element data uses malloc)
  */
 typedef struct {
 	ListNode *head;
 	ListNode *tail;
 	size_t size;
+	Allocator allocator;
 } List;
 
 /**
@@ -42,6 +45,11 @@ typedef struct {
  */
 int list_init(List *list);
 
+/**
+ * @brief Initialize a new empty list whose nodes come from allocator
+ */
+int list_init_with_allocator(List *list, Allocator allocator);
+
 /**
  * @brief Add element to the end of the list
  */
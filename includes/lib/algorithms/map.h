@@ -6,13 +6,14 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 12:39:03 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 12:39:03 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #ifndef MAP_H
 #define MAP_H
 
+#include <lib/pool.h>
 #include <stddef.h>
 
 /**
@@ -41,6 +42,7 @@ typedef struct {
 	size_t key_size;
 	size_t (*hash_func)(const void *key);
 	int (*compare_func)(const void *key1, const void *key2);
+	Allocator allocator; // Entries and keys (values use malloc)
 } Map;
 
 /**
@@ -53,6 +55,11 @@ typedef struct {
  */
 int map_init(Map *map, size_t initial_capacity, size_t key_size, size_t (*hash_func)(const void *), int (*compare_func)(const void *, const void *));
 
+/**
+ * @brief Initialize a new map whose entries and keys come from allocator
+ */
+int map_init_with_allocator(Map *map, size_t initial_capacity, size_t key_size, size_t (*hash_func)(const void *), int (*compare_func)(const void *, const void *), Allocator allocator);
+
 /**
  * @brief Insert or update key-value pair
  */
@@ -6,13 +6,14 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 12:40:30 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 21:06:36 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #ifndef RB_TREE_H
 #define RB_TREE_H
 
+#include <lib/pool.h>
 #include <stddef.h>
 
 typedef enum {
@@ -39,12 +40,14 @@ typedef struct RBNode {
  * @param size Current number of nodes
  * @param key_size Size of key type
  * @param compare_func Function to compare keys
+ * @param allocator Source of nodes and keys (values use malloc)
  */
 typedef struct {
 	RBNode *root;
 	size_t size;
 	size_t key_size;
 	int (*compare_func)(const void *, const void *);
+	Allocator allocator;
 } RBTree;
 
 /**
@@ -57,6 +60,11 @@ typedef struct {
  */
 int rb_tree_init(RBTree *tree, size_t key_size, int (*compare_func)(const void *, const void *));
 
+/**
+ * @brief Initialize a new Red-Black Tree whose nodes and keys come from allocator
+ */
+int rb_tree_init_with_allocator(RBTree *tree, size_t key_size, int (*compare_func)(const void *, const void *), Allocator allocator);
+
 /**
  * @brief Insert key-value pair into the tree
  */
@@ -6,13 +6,14 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 20:02:22 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 20:58:45 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #ifndef SKIP_LIST_H
 #define SKIP_LIST_H
 
+#include <lib/pool.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -48,6 +49,7 @@ typedef struct SkipList {
 	SkipNode *header; /**< Header node (sentinel) */
 	int level;		  /**< Current maximum level in the skip list */
 	int size;		  /**< Number of elements in the skip list */
+	Allocator allocator; /**< Source of nodes and their forward arrays */
 } SkipList;
 
 /**
@@ -60,6 +62,16 @@ typedef struct SkipList {
  */
 SkipList *skip_list_create(void);
 
+/**
+ * @brief Creates a new empty skip list whose nodes come from allocator
+ *
+ * The list structure itself still uses malloc.
+ *
+ * @param allocator Allocator for nodes and forward arrays
+ * @return SkipList* Pointer to the new skip list, or NULL if allocation fails
+ */
+SkipList *skip_list_create_with_allocator(Allocator allocator);
+
 /**
  * @brief Destroys a skip list and frees all associated memory
  *
@@ -80,7 +92,7 @@ void skip_list_destroy(SkipList *list);
  * @param list The skip list to insert into
  * @param key The key to insert/update
  * @param value Pointer to the value to store
- * @return int 1 if a new node was created, 0 if value was updated
+ * @return int 1 if a new node was created, 0 if value was updated, -1 if allocation fails
  */
 int skip_list_insert(SkipList *list, int key, void *value);
 
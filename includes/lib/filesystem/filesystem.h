@@ -11,8 +11,10 @@
 #ifndef FILESYSTEM_H
 #define FILESYSTEM_H
 
+#include <dirent.h>
 #include <fcntl.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -69,11 +71,25 @@ typedef struct s_file {
 	int fd;
 	int mode;
 	off_t offset;
-	uint32_t size;
+	off_t size;
 	bool is_directory;
 	t_metadata *metadata;
 } t_file;
 
+// Options de fs_map (combinables)
+#define FS_MAP_READ 0			  // Lecture seule
+#define FS_MAP_WRITE (1 << 0)	  // Lecture-écriture, écrit dans le fichier (MAP_SHARED)
+#define FS_MAP_SEQUENTIAL (1 << 1) // Accès séquentiel : lecture anticipée agressive
+#define FS_MAP_RANDOM (1 << 2)	  // Accès aléatoire : pas de lecture anticipée
+#define FS_MAP_HUGE_PAGES (1 << 3) // Huge pages transparentes si le noyau le permet
+#define FS_MAP_POPULATE (1 << 4)	  // Charger tout le fichier dès le mapping
+
+typedef struct s_mapping {
+	void *data;	   // NULL pour un fichier vide
+	size_t length; // Taille du fichier au moment du mapping
+	int flags;	   // Options FS_MAP_*
+} t_mapping;
+
 typedef struct s_dir_entry {
 	char *name;
 	bool is_directory;
@@ -99,6 +115,19 @@ int fs_delete(const char *path);
 uint32_t fs_get_size(const char *path);
 bool fs_is_file(const char *path);
 
+// Variantes 64 bits : tailles size_t / off_t, codes FS_* négatifs en cas
+// d'erreur. fs_pread/fs_pwrite ne déplacent pas file->offset.
+ssize_t fs_read64(t_file *file, void *buffer, size_t size);
+ssize_t fs_write64(t_file *file, const void *buffer, size_t size);
+ssize_t fs_pread(t_file *file, void *buffer, size_t size, off_t offset);
+ssize_t fs_pwrite(t_file *file, const void *buffer, size_t size, off_t offset);
+off_t fs_get_size64(const char *path); // FS_ERROR si le fichier est inaccessible
+
+// Memory-Mapped Files
+t_mapping *fs_map(const char *path, int flags);
+int fs_map_sync(t_mapping *mapping);
+int fs_unmap(t_mapping *mapping);
+
 // Directory Operations
 t_dir_entry *fs_list_directory(const char *path);
 void fs_free_dir_entries(t_dir_entry *entries);
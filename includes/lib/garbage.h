@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 11:11:52 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 11:34:52 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,23 +14,87 @@
 #define GARBAGE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
+/** Call-site counters of a profile, private to the allocator */
+typedef struct GarbageSite GarbageSite;
+
 /**
  * @brief Structure representing an allocated memory trace.
  */
 typedef struct MemoryBlock {
-	void *ptr;				  /**< Pointer to allocated memory */
-	size_t size;			  /**< Size of allocated memory */
-	time_t allocation_time;	  /**< Allocation timestamp */
-	struct MemoryBlock *prev; /**< Pointer to previous block */
-	struct MemoryBlock *next; /**< Pointer to next block */
+	void *ptr;					  /**< Pointer to allocated memory */
+	size_t size;				  /**< Size of allocated memory */
+	time_t allocation_time;		  /**< Allocation timestamp */
+	struct MemoryBlock *prev;	  /**< Pointer to previous block */
+	struct MemoryBlock *next;	  /**< Pointer to next block */
+	struct GarbageContext *owner; /**< Context whose list holds the block */
+	GarbageSite *site;			  /**< Allocating call site (profiled contexts), else NULL */
 } MemoryBlock;
 
+/**
+ * @brief How a context stores its tracking records.
+ */
+typedef enum GarbageMode {
+	GC_MODE_INDEXED,  /**< Separate record per block, found through a pointer index */
+	GC_MODE_EMBEDDED, /**< Record stored in a header just before each gc_* block */
+	GC_MODE_ARENA,	  /**< Bump allocation out of chunks, no per-block record */
+	GC_MODE_SAMPLED,  /**< Indexed records for a Poisson sample of the blocks */
+} GarbageMode;
+
+/** Default mean number of bytes allocated between two sampled blocks */
+#define GC_SAMPLE_PERIOD (512 * 1024)
+
+/** Default capacity of an arena chunk, in bytes */
+#define GC_ARENA_CHUNK_SIZE (64 * 1024)
+
+/** Arena chunk, private to the allocator */
+typedef struct GarbageChunk GarbageChunk;
+
+/** Per-thread caches of a shared context, private to the allocator */
+typedef struct GarbageThreads GarbageThreads;
+
+/** Allocation profile, see garbage_profile_enable() */
+typedef struct GarbageProfile GarbageProfile;
+
+/** Profile counters of a context or thread cache, private to the allocator */
+typedef struct GarbageCounterSet GarbageCounterSet;
+
+/** Number of log2 size classes: class k holds sizes below 2^k */
+#define GC_PROFILE_SIZE_CLASSES 48
+/** Capacity of the call-site table; further sites are counted as "other" */
+#define GC_PROFILE_MAX_SITES 1024
+/** Allocations between two allocation-rate samples (a power of two) */
+#define GC_PROFILE_RATE_STRIDE 4096
+/** Number of rate samples kept, the oldest being overwritten */
+#define GC_PROFILE_RATE_SAMPLES 64
+
+/**
+ * @brief Saved arena position, see garbage_mark().
+ */
+typedef struct GarbageMark {
+	GarbageChunk *chunk;   /**< Newest chunk when the mark was taken */
+	size_t used;		   /**< Bytes used in that chunk */
+	size_t live;		   /**< Allocations live at the mark */
+	size_t allocated_size; /**< Bytes allocated at the mark */
+} GarbageMark;
+
 /**
  * @brief Structure representing the garbage manager context.
+ *
+ * Blocks are kept in allocation order in the linked list (reports, oldest
+ * first). In indexed mode they are also indexed by pointer in an
+ * open-addressing table, so finding or removing a block does not depend on
+ * how many are live. In embedded mode the list nodes are the block headers
+ * and the index is unused. In arena mode there is no list: blocks are
+ * carved out of chunks and released together.
+ *
+ * A shared context (garbage_shared_create()) tracks nothing itself: each
+ * thread works on a cache context of its own, and the counters here are
+ * only brought up to date by garbage_merge_stats().
  */
 typedef struct GarbageContext {
 	size_t total_allocations;	   /**< Total number of allocations made */
@@ -38,6 +102,20 @@ typedef struct GarbageContext {
 	size_t current_allocated_size; /**< Current total allocated memory size */
 	MemoryBlock *head;			   /**< First block in the linked list */
 	MemoryBlock *tail;			   /**< Last block in the linked list */
+	MemoryBlock **index;		   /**< Pointer -> block table (linear probing) */
+	size_t index_capacity;		   /**< Number of slots, a power of two */
+	size_t index_count;			   /**< Number of indexed blocks */
+	GarbageMode mode;			   /**< Record storage, set at init */
+	GarbageChunk *chunks;		   /**< Newest arena chunk (arena mode) */
+	GarbageChunk *spare;		   /**< Released chunk kept for reuse */
+	size_t chunk_size;			   /**< Capacity of regular arena chunks */
+	GarbageThreads *threads;	   /**< Thread caches (shared contexts), else NULL */
+	bool verbose_mode;			   /**< Print allocation and free messages */
+	GarbageProfile *profile;	   /**< Allocation profile, else NULL */
+	GarbageCounterSet *counters;   /**< Profile counters it updates, else NULL */
+	size_t sample_period;		   /**< Mean bytes between samples (sampled mode) */
+	size_t bytes_until_sample;	   /**< Bytes left before the next sample */
+	uint64_t sample_state;		   /**< Sampler random state */
 } GarbageContext;
 
 /**
@@ -50,10 +128,217 @@ typedef struct GarbageContext {
  */
 GarbageContext *garbage_init(bool verbose_mode);
 
+/**
+ * @brief Initialize the garbage manager with a given record storage mode.
+ *
+ * GC_MODE_EMBEDDED makes each gc_malloc a single allocation (header plus
+ * user block) and gc_free a constant-time unlink with no lookup, and skips
+ * the allocation timestamp. Only memory from the gc_* allocators can be
+ * tracked: garbage_add_block and garbage_remove_block report an error, and
+ * garbage_find_block walks the list.
+ *
+ * gc_free and gc_realloc trust the header in front of the pointer, so in
+ * this mode freeing a pointer twice, or passing one that the gc_*
+ * allocators did not return, is undefined behaviour rather than an error.
+ *
+ * @param[in] verbose_mode Enable/disable verbose mode (message display)
+ * @param[in] mode Record storage mode
+ * @return GarbageContext* Pointer to initialized context, or NULL on error
+ */
+GarbageContext *garbage_init_mode(bool verbose_mode, GarbageMode mode);
+
+/**
+ * @brief Initialize the garbage manager in sampled mode.
+ *
+ * Allocated bytes are sampled as a Poisson process of mean period bytes
+ * (as in tcmalloc's heap profiler): a block of size bytes is recorded with
+ * probability 1 - exp(-size / period), so large blocks are almost always
+ * seen and small ones rarely. Only recorded blocks are counted in the
+ * context statistics and listed by garbage_report_usage();
+ * garbage_estimate_live() and the report scale them back up to estimates
+ * for all blocks. Unrecorded blocks are plain malloc() blocks that gc_free
+ * releases without complaint, so double frees are no longer detected.
+ * garbage_cleanup() frees recorded blocks only: skipped blocks not freed
+ * with gc_free() leak. garbage_add_block() samples too. Sampled mode
+ * cannot be shared.
+ *
+ * @param[in] verbose_mode Enable/disable verbose mode (message display)
+ * @param[in] period Mean sampling period in bytes, 0 for GC_SAMPLE_PERIOD
+ * @return GarbageContext* Pointer to initialized context, or NULL on error
+ */
+GarbageContext *garbage_init_sampled(bool verbose_mode, size_t period);
+
+/**
+ * @brief Reseed the sampler of a sampled context.
+ *
+ * The sampler is seeded from the clock; a fixed seed makes the choice of
+ * recorded blocks reproducible, e.g. in tests. No-op in other modes.
+ *
+ * @param[in] ctx Garbage manager context
+ * @param[in] seed Any value
+ */
+void garbage_sample_seed(GarbageContext *ctx, uint64_t seed);
+
+/**
+ * @brief Estimate the live blocks and bytes of a context.
+ *
+ * Exact in every mode but sampled mode, where each recorded block stands
+ * for 1 / (1 - exp(-size / period)) blocks of its size.
+ *
+ * @param[in] ctx Garbage manager context
+ * @param[out] blocks Estimated number of live blocks (may be NULL)
+ * @param[out] bytes Estimated number of live bytes (may be NULL)
+ */
+void garbage_estimate_live(GarbageContext *ctx, size_t *blocks, size_t *bytes);
+
+/**
+ * @brief Create a standalone arena context.
+ *
+ * gc_malloc, gc_calloc, gc_strdup and gc_realloc bump-allocate out of
+ * chunks of chunk_size bytes (larger requests get a chunk of their own).
+ * gc_free is a no-op: memory comes back through garbage_rewind(),
+ * garbage_cleanup() or garbage_arena_destroy(), in O(chunks). Growing a
+ * block with gc_realloc copies it and leaves the old copy in the arena.
+ *
+ * @param[in] chunk_size Chunk capacity, 0 for GC_ARENA_CHUNK_SIZE
+ * @return GarbageContext* New arena context, or NULL on error
+ */
+GarbageContext *garbage_arena_create(size_t chunk_size);
+
+/**
+ * @brief Free every chunk of an arena context and the context itself.
+ *
+ * @param[in] ctx Context from garbage_arena_create()
+ */
+void garbage_arena_destroy(GarbageContext *ctx);
+
+/**
+ * @brief Save the current arena position.
+ *
+ * Marks nest: rewind them in reverse order. A mark is invalid once the
+ * arena has been rewound to an older one or cleaned up.
+ *
+ * @param[in] ctx Arena context
+ * @return GarbageMark Position to pass to garbage_rewind()
+ */
+GarbageMark garbage_mark(GarbageContext *ctx);
+
+/**
+ * @brief Release everything allocated since a mark.
+ *
+ * @param[in] ctx Arena context
+ * @param[in] mark Position from garbage_mark()
+ */
+void garbage_rewind(GarbageContext *ctx, GarbageMark mark);
+
+/**
+ * @brief Create a context that several threads may use at once.
+ *
+ * Each thread allocates into a cache context of its own, guarded by its
+ * own lock, so threads allocating and freeing their own blocks never
+ * contend. A block may be freed or reallocated from any thread: in
+ * embedded mode its header names the owning cache, in indexed mode the
+ * caller's cache is searched first, then the other threads' caches one
+ * lock at a time (embedded mode trusts the header, see
+ * garbage_init_mode()). A cross-thread free in indexed mode therefore
+ * costs a lookup per thread and briefly locks each cache; it does not
+ * scale to producer/consumer workloads, where one thread frees what
+ * another allocates. Use embedded mode there: its frees take only the
+ * owner's lock.
+ * Caches outlive their thread (its blocks may still be freed elsewhere)
+ * and are handed to the next thread that starts using the context.
+ *
+ * garbage_free_oldest_block() works on the calling thread's cache.
+ * Pointers returned by garbage_find_block() are only stable while no
+ * other thread frees that block.
+ *
+ * @param[in] verbose_mode Enable/disable verbose mode for this context only
+ * @param[in] mode GC_MODE_INDEXED or GC_MODE_EMBEDDED
+ * @return GarbageContext* New shared context, or NULL on error
+ */
+GarbageContext *garbage_shared_create(bool verbose_mode, GarbageMode mode);
+
+/**
+ * @brief Free every block and cache of a shared context, and the context.
+ *
+ * No other thread may be using the context at this point.
+ *
+ * @param[in] ctx Context from garbage_shared_create()
+ */
+void garbage_shared_destroy(GarbageContext *ctx);
+
+/**
+ * @brief Refresh the counters of a shared context from its thread caches.
+ *
+ * Called by garbage_report_usage(); a no-op on other contexts, whose
+ * counters are always current.
+ *
+ * @param[in] ctx Garbage manager context
+ */
+void garbage_merge_stats(GarbageContext *ctx);
+
+/**
+ * @brief Start profiling the allocations of a context.
+ *
+ * From then on every allocation and free updates, in constant time and
+ * without taking a lock, counters per log2 size class and per call site
+ * and live and peak byte totals. Every GC_PROFILE_RATE_STRIDE allocations
+ * one of them also records a timestamped allocation-rate sample, under a
+ * lock. Each thread of a shared context counts into its own cache, so
+ * threads never contend on counters; garbage_profile_dump() sums them,
+ * and reports as peak the sum of the per-thread peaks (an upper bound).
+ * Call sites are the return address into the caller of gc_*, or the
+ * calling thread's garbage_profile_tag().
+ * Blocks allocated before profiling started are not counted, nor, in
+ * sampled mode, blocks the sampler skips.
+ *
+ * The profile lives until garbage_cleanup() or garbage_shared_destroy().
+ * A shared context must be profiled before other threads start using it.
+ * Arena contexts, which keep no per-block record, cannot be profiled.
+ *
+ * @param[in] ctx Garbage manager context
+ * @return true if the context is (now) profiled, false on error
+ */
+bool garbage_profile_enable(GarbageContext *ctx);
+
+/**
+ * @brief Attribute the calling thread's next allocations to a tag.
+ *
+ * @param[in] tag Static string naming the site, NULL for return addresses
+ * @return const char* The previous tag, to restore nested scopes
+ */
+const char *garbage_profile_tag(const char *tag);
+
+/**
+ * @brief Write the profile of a context in a line-based text format.
+ *
+ * One record per line, fields separated by spaces, counters as decimal
+ * integers; records with no allocation are skipped:
+ *
+ *     gcprof 1
+ *     total <allocations> <frees> <bytes> <live_bytes> <peak_bytes>
+ *     class <max_size> <allocations> <frees> <bytes> <live_bytes>
+ *     site <0xaddress> <allocations> <frees> <bytes> <live_bytes>
+ *     tag <name> <allocations> <frees> <bytes> <live_bytes>
+ *     other <allocations> <frees> <bytes> <live_bytes>
+ *     rate <elapsed_ns> <allocations> <bytes>
+ *
+ * class covers sizes from half its max_size up to max_size bytes (the
+ * last one prints inf and has no bound); rate samples are cumulative
+ * totals, oldest first.
+ *
+ * @param[in] ctx Profiled context
+ * @param[in] out Stream to write to
+ * @return true on success, false if ctx is not profiled
+ */
+bool garbage_profile_dump(GarbageContext *ctx, FILE *out);
+
 /**
  * @brief Free allocated memory and release garbage manager resources.
  *
- * Cleans up all previous allocations and frees the context.
+ * Cleans up all previous allocations and frees the context. In sampled
+ * mode only the recorded blocks are known, so only they are freed: every
+ * block the sampler skipped must still be released with gc_free().
  *
  * @param[in] ctx Garbage manager context
  */
@@ -73,7 +358,8 @@ void garbage_add_block(GarbageContext *ctx, void *ptr, size_t size);
 /**
  * @brief Remove a memory block from the list of allocated blocks.
  *
- * Used to notify the manager that a free has occurred.
+ * Used to notify the manager that a free has occurred. The memory itself
+ * is not released; gc_free() does both.
  *
  * @param[in] ctx Garbage manager context
  * @param[in] ptr Pointer to memory to free
@@ -103,7 +389,8 @@ MemoryBlock *garbage_find_block(GarbageContext *ctx, void *ptr);
 /**
  * @brief Free the oldest memory block.
  *
- * Used for manual object lifecycle management.
+ * Used for manual object lifecycle management. Releases the memory and
+ * stops tracking it.
  *
  * @param[in] ctx Garbage manager context
  */
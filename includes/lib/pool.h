@@ -0,0 +1,123 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   pool.h                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/**
+ * @brief Pluggable allocator for container nodes.
+ *
+ * free receives the size given to alloc, so size-class allocators need no
+ * per-block header. A zero-initialised Allocator means malloc/free.
+ */
+typedef struct Allocator {
+	void *(*alloc)(void *ctx, size_t size);			 /**< Allocate size bytes */
+	void (*free)(void *ctx, void *ptr, size_t size); /**< Release a block of size bytes */
+	void *ctx;										 /**< Passed back to both hooks */
+} Allocator;
+
+static inline void *allocator_alloc(const Allocator *allocator, size_t size) {
+	return allocator->alloc ? allocator->alloc(allocator->ctx, size) : malloc(size);
+}
+
+static inline void allocator_free(const Allocator *allocator, void *ptr, size_t size) {
+	if (allocator->free) {
+		allocator->free(allocator->ctx, ptr, size);
+	} else {
+		free(ptr);
+	}
+}
+
+/** Alignment of pool objects and step between size classes */
+#define POOL_ALIGN 16
+/** Size classes of 16, 32, ..., 256 bytes; larger requests go to malloc */
+#define POOL_CLASS_COUNT 16
+#define POOL_MAX_SIZE (POOL_ALIGN * POOL_CLASS_COUNT)
+/** Bytes carved per slab */
+#define POOL_SLAB_SIZE (64 * 1024)
+
+typedef struct PoolObject PoolObject;
+typedef struct PoolSlab PoolSlab;
+typedef struct PoolCache PoolCache;
+
+/**
+ * @brief Object pool: per-size-class freelists over shared slabs.
+ *
+ * Objects of up to POOL_MAX_SIZE bytes are carved out of POOL_SLAB_SIZE
+ * slabs and recycled through one freelist per 16-byte size class; they
+ * return to the system only when the pool is destroyed. With thread caches
+ * enabled the pool may be shared between threads: each thread keeps a few
+ * objects per class and refills or flushes them in batches under the pool
+ * lock, so most calls take no lock at all.
+ */
+typedef struct ObjectPool {
+	PoolObject *free_lists[POOL_CLASS_COUNT]; /**< Recycled objects per class */
+	char *bump[POOL_CLASS_COUNT];			  /**< Next uncarved object per class */
+	char *bump_end[POOL_CLASS_COUNT];		  /**< End of the slab being carved */
+	PoolSlab *slabs;						  /**< Every slab, released at destroy */
+	bool thread_cache;						  /**< Shared between threads */
+	pthread_mutex_t lock;					  /**< Guards the fields above (thread cache mode) */
+	pthread_key_t cache_key;				  /**< Calling thread's PoolCache */
+	PoolCache *caches;						  /**< Registered thread caches */
+} ObjectPool;
+
+/**
+ * @brief Initialize an empty pool.
+ *
+ * @param[out] pool Pool to initialize
+ * @param[in] thread_cache Allow concurrent use through per-thread caches
+ * @return true on success, false if the thread cache could not be set up
+ */
+bool pool_init(ObjectPool *pool, bool thread_cache);
+
+/**
+ * @brief Release every slab and thread cache of the pool.
+ *
+ * Objects still in use become invalid. No other thread may be using the
+ * pool at this point.
+ *
+ * @param[in] pool Pool to destroy
+ */
+void pool_destroy(ObjectPool *pool);
+
+/**
+ * @brief Allocate size bytes, aligned to POOL_ALIGN.
+ *
+ * @param[in] pool Pool to allocate from
+ * @param[in] size Object size
+ * @return void* New object, or NULL on error
+ */
+void *pool_alloc(ObjectPool *pool, size_t size);
+
+/**
+ * @brief Return an object to the pool.
+ *
+ * @param[in] pool Pool the object came from
+ * @param[in] ptr Object from pool_alloc(), or NULL
+ * @param[in] size Size passed to pool_alloc()
+ */
+void pool_free(ObjectPool *pool, void *ptr, size_t size);
+
+/**
+ * @brief Allocator hook backed by the pool, for *_init_with_allocator.
+ *
+ * @param[in] pool Pool, which must outlive every container using it
+ * @return Allocator Hook allocating from pool
+ */
+Allocator pool_allocator(ObjectPool *pool);
+
+#endif // POOL_H
@@ -6,13 +6,15 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/14 11:11:48 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/03/14 11:21:04 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #ifndef SORT_H
 # define SORT_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /* Sorting algorithms */
@@ -34,4 +36,71 @@ void radix_sort(void *array, size_t size, size_t elem_size,
 /* Specialized radix sort for integers */
 void radix_sort_int(int *array, size_t size);
 
+/* Type-specialised introsorts, no comparator calls */
+void sort_int(int *array, size_t size);
+void sort_uint(unsigned int *array, size_t size);
+void sort_long(long *array, size_t size);
+void sort_ulong(unsigned long *array, size_t size);
+void sort_i64(int64_t *array, size_t size);
+void sort_u64(uint64_t *array, size_t size);
+void sort_float(float *array, size_t size);
+void sort_double(double *array, size_t size);
+
+/* Stable sort of records on an extracted 64-bit key */
+void sort_by_key(void *array, size_t size, size_t elem_size,
+                 uint64_t (*key)(const void *));
+
+/* Sorting networks for small arrays (AVX2 when available, scalar otherwise) */
+#define SORT_NETWORK_MAX 64
+
+void sort_network_i32(int32_t *array, size_t size);
+void sort_network_u32(uint32_t *array, size_t size);
+void sort_network_i64(int64_t *array, size_t size);
+void sort_network_u64(uint64_t *array, size_t size);
+
+/* Runs the specialised kernel matching a compare_* function, if any */
+bool sort_typed(void *array, size_t size, size_t elem_size,
+                int (*compare)(const void *, const void *));
+
+/* Parallel stable merge sort */
+void parallel_sort(void *array, size_t size, size_t elem_size,
+                  int (*compare)(const void *, const void *));
+
+void parallel_sort_threads(void *array, size_t size, size_t elem_size,
+                          int (*compare)(const void *, const void *), size_t threads);
+
+/* Thread count used by parallel_sort, 0 means one per online CPU */
+void parallel_sort_set_threads(size_t threads);
+size_t parallel_sort_get_threads(void);
+
+/* Selection: nth element in place, k smallest sorted in front */
+void nth_element(void *array, size_t size, size_t nth, size_t elem_size,
+                 int (*compare)(const void *, const void *));
+
+void partial_sort(void *array, size_t size, size_t k, size_t elem_size,
+                  int (*compare)(const void *, const void *));
+
+/* Streaming selector keeping the k greatest elements in a min-heap */
+typedef struct TopK
+{
+    unsigned char *heap;
+    size_t count;
+    size_t capacity;
+    size_t elem_size;
+    int (*compare)(const void *, const void *);
+} TopK;
+
+bool topk_init(TopK *topk, size_t k, size_t elem_size,
+               int (*compare)(const void *, const void *));
+bool topk_push(TopK *topk, const void *elem);
+size_t topk_size(const TopK *topk);
+size_t topk_sorted(const TopK *topk, void *out);
+void topk_clear(TopK *topk);
+void topk_destroy(TopK *topk);
+
+/* Sorts a file of fixed-size records larger than memory, returns FS_* codes */
+int external_sort(const char *input, const char *output, size_t record_size,
+                  int (*compare)(const void *, const void *),
+                  size_t memory_limit, const char *tmp_dir);
+
 #endif /* SORT_H */
\ No newline at end of file
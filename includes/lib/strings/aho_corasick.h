@@ -0,0 +1,53 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   aho_corasick.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Multi-pattern matcher. The patterns are compiled once into a complete
+ * DFA over byte classes (bytes that no pattern uses share one class), so
+ * a scan costs one table load per input byte whatever the pattern count.
+ * Matches are reported in order of their end offset, every occurrence of
+ * every pattern, overlaps included. Empty patterns are ignored.
+ */
+#define AC_NONE UINT32_MAX
+
+/* Return false to stop the scan */
+typedef bool (*AhoCorasickMatchFn)(size_t pattern, size_t start, size_t end, void *ctx);
+
+typedef struct AhoCorasick {
+	uint32_t *delta;	   // [state * classes + class] -> target row, AC_MATCH flag
+	uint32_t *output;	   // First pattern ending exactly at a state
+	uint32_t *dict_link;   // Nearest proper suffix state with an output
+	uint32_t *next_output; // Next pattern with the same text (duplicates)
+	size_t *lengths;	   // Pattern lengths
+	size_t num_states;
+	size_t num_classes;
+	size_t num_patterns;
+	uint8_t byte_class[256];
+} AhoCorasick;
+
+/* lengths may be NULL for NUL-terminated patterns */
+bool aho_corasick_init(AhoCorasick *ac, const char *const *patterns, const size_t *lengths, size_t count);
+void aho_corasick_destroy(AhoCorasick *ac);
+
+/* Returns the number of matches reported */
+size_t aho_corasick_scan(const AhoCorasick *ac, const char *text, size_t len, AhoCorasickMatchFn on_match,
+						 void *ctx);
+bool aho_corasick_contains(const AhoCorasick *ac, const char *text, size_t len);
+
+#endif // AHO_CORASICK_H
@@ -0,0 +1,83 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_builder.h                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef STRING_BUILDER_H
+#define STRING_BUILDER_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Length-tracked, growable string. Appends are amortised O(1) (capacity
+ * doubles), lengths are never recomputed, and the buffer is always
+ * NUL-terminated so str_builder_cstr() can be handed to any str_* function.
+ * Embedded NUL bytes are allowed; the builder functions use len, not NUL.
+ * Functions returning bool fail only when memory runs out, leaving the
+ * builder unchanged.
+ */
+#define STR_BUILDER_NPOS ((size_t)-1)
+
+typedef struct StrBuilder {
+	char *data;
+	size_t len;
+	size_t capacity; // Bytes available for content, terminator excluded
+} StrBuilder;
+
+/* Lifetime */
+bool str_builder_init(StrBuilder *sb, size_t capacity);
+bool str_builder_from(StrBuilder *sb, const char *str);
+void str_builder_destroy(StrBuilder *sb);
+bool str_builder_reserve(StrBuilder *sb, size_t extra);
+bool str_builder_shrink(StrBuilder *sb);
+void str_builder_clear(StrBuilder *sb);
+
+/* Conversion: cstr borrows, detach hands over the buffer and resets sb */
+const char *str_builder_cstr(const StrBuilder *sb);
+char *str_builder_detach(StrBuilder *sb);
+size_t str_builder_len(const StrBuilder *sb);
+
+/* Appending */
+bool str_builder_append(StrBuilder *sb, const char *str);
+bool str_builder_append_len(StrBuilder *sb, const char *data, size_t len);
+bool str_builder_append_char(StrBuilder *sb, char c);
+bool str_builder_append_repeat(StrBuilder *sb, char c, size_t count);
+bool str_builder_appendf(StrBuilder *sb, const char *format, ...) __attribute__((format(printf, 2, 3)));
+bool str_builder_vappendf(StrBuilder *sb, const char *format, va_list args);
+bool str_builder_join(StrBuilder *sb, const char **strings, const char *delim);
+bool str_builder_append_i64(StrBuilder *sb, int64_t value);
+bool str_builder_append_u64(StrBuilder *sb, uint64_t value);
+bool str_builder_append_double(StrBuilder *sb, double value);
+
+/* Editing */
+bool str_builder_insert(StrBuilder *sb, size_t pos, const char *str);
+void str_builder_erase(StrBuilder *sb, size_t pos, size_t len);
+void str_builder_truncate(StrBuilder *sb, size_t len);
+bool str_builder_replace(StrBuilder *sb, const char *old, const char *new);
+
+/* Manipulation, in place */
+void str_builder_upper(StrBuilder *sb);
+void str_builder_lower(StrBuilder *sb);
+void str_builder_capitalize(StrBuilder *sb);
+void str_builder_reverse(StrBuilder *sb);
+void str_builder_trim(StrBuilder *sb);
+void str_builder_trim_left(StrBuilder *sb);
+void str_builder_trim_right(StrBuilder *sb);
+
+/* Queries */
+size_t str_builder_find(const StrBuilder *sb, const char *needle, size_t from);
+bool str_builder_equals(const StrBuilder *sb, const char *str);
+bool str_builder_starts_with(const StrBuilder *sb, const char *prefix);
+bool str_builder_ends_with(const StrBuilder *sb, const char *suffix);
+
+#endif // STRING_BUILDER_H
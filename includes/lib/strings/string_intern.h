@@ -0,0 +1,64 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_intern.h                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+#include "../algorithms/hash_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * String interning. Each distinct string is stored once, in an arena of
+ * chunks that never move, and gets a stable canonical pointer plus a dense
+ * id (0, 1, 2, ... in first-seen order). Two interned strings from the
+ * same pool are equal exactly when their pointers (or ids) are equal.
+ * Canonical pointers stay valid until str_intern_destroy.
+ */
+#define STR_INTERN_NONE UINT32_MAX
+
+typedef struct StrInternChunk {
+	struct StrInternChunk *next;
+	size_t used;
+	size_t capacity;
+	char data[];
+} StrInternChunk;
+
+typedef struct StrInternPool {
+	HashTable table;	  // Canonical const char * -> uint32_t id
+	const char **strings; // Id -> canonical pointer
+	size_t count;
+	size_t capacity;
+	StrInternChunk *chunks; // Newest first
+	size_t bytes;			// String bytes stored, terminators included
+} StrInternPool;
+
+bool str_intern_init(StrInternPool *pool, size_t initial_capacity);
+void str_intern_destroy(StrInternPool *pool);
+
+/* Canonical pointer for str, adding it if new; NULL only on allocation failure */
+const char *str_intern(StrInternPool *pool, const char *str);
+/* Same for len bytes; interned strings are C strings, so NULL if they contain a NUL */
+const char *str_intern_len(StrInternPool *pool, const char *data, size_t len);
+
+/* Id for str, adding it if new; STR_INTERN_NONE only on allocation failure */
+uint32_t str_intern_id(StrInternPool *pool, const char *str);
+
+/* Lookups that never add: NULL / STR_INTERN_NONE when str is not interned */
+const char *str_intern_lookup(const StrInternPool *pool, const char *str);
+uint32_t str_intern_lookup_id(const StrInternPool *pool, const char *str);
+
+const char *str_intern_string(const StrInternPool *pool, uint32_t id);
+size_t str_intern_count(const StrInternPool *pool);
+
+#endif // STRING_INTERN_H
@@ -0,0 +1,61 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_replace.h                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef STRING_REPLACE_H
+#define STRING_REPLACE_H
+
+#include "string_builder.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Batch replacement: any number of (old, new) pairs applied in a single
+ * left-to-right pass. At each position the longest matching old wins
+ * (the first listed on ties); replacements are not rescanned and empty
+ * olds are ignored. A replacer is compiled once; applying it only
+ * allocates when the output goes to a growing StrBuilder.
+ */
+typedef struct StrReplacePair {
+	const char *old;
+	const char *new;
+} StrReplacePair;
+
+typedef struct StrReplaceEntry {
+	size_t old_len;
+	size_t new_len;
+	uint32_t next; // Next pair with the same first byte, longest first
+} StrReplaceEntry;
+
+typedef struct StrReplacer {
+	const StrReplacePair *pairs; // Referenced, not copied
+	StrReplaceEntry *entries;
+	size_t count;
+	uint32_t bucket[256]; // First pair for each leading byte
+	int first_bytes;	  // Distinct leading bytes
+	unsigned char only_first;
+} StrReplacer;
+
+bool str_replacer_init(StrReplacer *replacer, const StrReplacePair *pairs, size_t count);
+void str_replacer_destroy(StrReplacer *replacer);
+
+/* str_lcpy-style: returns the full result length, writes what fits */
+size_t str_replacer_apply_into(const StrReplacer *replacer, const char *str, size_t len, char *dest, size_t size);
+bool str_replacer_apply(const StrReplacer *replacer, const char *str, size_t len, StrBuilder *out);
+
+/* Single pair, appended to a builder in one pass (see str_replace_into) */
+bool str_builder_append_replace(StrBuilder *sb, const char *str, const char *old, const char *new);
+
+/* One-shot convenience returning a new string */
+char *str_replace_many(const char *str, const StrReplacePair *pairs, size_t count);
+
+#endif // STRING_REPLACE_H
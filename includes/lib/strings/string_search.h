@@ -0,0 +1,55 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_search.h                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef STRING_SEARCH_H
+#define STRING_SEARCH_H
+
+#include <stddef.h>
+
+/*
+ * Substring search engine. A searcher is prepared once per needle and can
+ * then scan any number of haystacks without allocating. The strategy
+ * depends on the needle length:
+ *   1 byte          memchr
+ *   2..32 bytes     SIMD filter on the first and last needle bytes
+ *   33..256 bytes   Horspool
+ *   longer          Two-Way (linear worst case, constant space)
+ * The needle is referenced, not copied: it must outlive the searcher.
+ */
+#define STR_SEARCH_FILTER_MAX 32
+#define STR_SEARCH_HORSPOOL_MAX 256
+
+typedef enum StrSearchKind {
+	STR_SEARCH_EMPTY,
+	STR_SEARCH_BYTE,
+	STR_SEARCH_FILTER,
+	STR_SEARCH_HORSPOOL,
+	STR_SEARCH_TWO_WAY,
+} StrSearchKind;
+
+typedef struct StrSearcher {
+	const unsigned char *needle;
+	size_t len;
+	StrSearchKind kind;
+	size_t shift[256]; // Horspool skips, or last position + 1 for Two-Way
+	size_t critical;   // Two-Way critical factorisation position
+	size_t period;	   // Two-Way period
+	size_t memory;	   // Two-Way prefix memory for periodic needles
+} StrSearcher;
+
+void str_searcher_init(StrSearcher *searcher, const char *needle, size_t needle_len);
+char *str_searcher_find(const StrSearcher *searcher, const char *haystack, size_t haystack_len);
+
+/* One-shot search over explicit lengths, NULL if absent */
+char *str_memstr(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len);
+
+#endif // STRING_SEARCH_H
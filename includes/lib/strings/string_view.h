@@ -0,0 +1,85 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_view.h                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include "string_search.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Non-owning string slice. Views point into a buffer owned by someone
+ * else and are never NUL-terminated: print them with STR_VIEW_FMT and
+ * STR_VIEW_ARG, or copy them out with str_view_copy / str_view_dup.
+ * Nothing here allocates except str_view_dup.
+ */
+#define STR_VIEW_NPOS ((size_t)-1)
+#define STR_VIEW_FMT "%.*s"
+#define STR_VIEW_ARG(v) (int)(v).len, (v).data
+
+typedef struct StrView {
+	const char *data;
+	size_t len;
+} StrView;
+
+/* Construction and conversion */
+StrView str_view(const char *str);
+StrView str_view_len(const char *data, size_t len);
+StrView str_view_sub(StrView view, size_t start, size_t len);
+size_t str_view_copy(StrView view, char *dest, size_t size);
+char *str_view_dup(StrView view);
+
+/* Trimming (same whitespace set as str_trim) */
+StrView str_view_trim(StrView view);
+StrView str_view_trim_left(StrView view);
+StrView str_view_trim_right(StrView view);
+
+/* Comparison and search */
+bool str_view_empty(StrView view);
+bool str_view_equals(StrView a, StrView b);
+bool str_view_case_equals(StrView a, StrView b);
+int str_view_cmp(StrView a, StrView b);
+bool str_view_starts_with(StrView view, StrView prefix);
+bool str_view_ends_with(StrView view, StrView suffix);
+size_t str_view_find(StrView view, StrView needle);
+size_t str_view_find_char(StrView view, char c);
+
+/*
+ * Split on every occurrence of an exact delimiter. Empty fields are kept,
+ * so "a,,b" gives "a", "", "b" and an empty text gives one empty field.
+ * An empty delimiter yields the whole text as a single field.
+ */
+typedef struct StrSplitIter {
+	const char *pos;
+	const char *end;
+	bool done;
+	StrSearcher searcher;
+} StrSplitIter;
+
+void str_split_iter_init(StrSplitIter *iter, StrView text, StrView delim);
+bool str_split_iter_next(StrSplitIter *iter, StrView *field);
+
+/*
+ * Tokenise on a set of delimiter bytes, like str_split and strtok: runs of
+ * delimiters separate tokens and empty tokens are skipped.
+ */
+typedef struct StrTokenIter {
+	const char *pos;
+	const char *end;
+	bool delim[256];
+} StrTokenIter;
+
+void str_token_iter_init(StrTokenIter *iter, StrView text, const char *delims);
+bool str_token_iter_next(StrTokenIter *iter, StrView *token);
+
+#endif // STRING_VIEW_H
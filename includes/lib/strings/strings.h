@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/31 10:54:53 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/31 12:33:55 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,6 +15,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* Basic string operations */
 size_t str_len(const char *str);
@@ -28,6 +29,7 @@ char *str_clone(const char *str);
 int str_cmp(const char *s1, const char *s2);
 int str_ncmp(const char *s1, const char *s2, size_t n);
 int str_case_cmp(const char *s1, const char *s2);
+bool str_case_equals(const char *s1, const char *s2);
 bool str_equals(const char *s1, const char *s2);
 bool str_starts_with(const char *str, const char *prefix);
 bool str_ends_with(const char *str, const char *suffix);
@@ -60,8 +62,22 @@ char *str_trim_right(char *str);
 char **str_split(const char *str, const char *delim);
 char *str_join(const char **strings, const char *delim);
 char *str_replace(const char *str, const char *old, const char *new);
+// Like str_lcpy: returns the full length; dest may be str if new is not longer than old
+size_t str_replace_into(char *dest, size_t size, const char *str, const char *old, const char *new);
 char *str_substr(const char *str, size_t start, size_t len);
 
+/*
+ * ASCII case folding over len bytes (no NUL needed), e.g. for protocol
+ * header names. dest may be src. Bytes outside A-Z and a-z, non-ASCII
+ * included, are left as they are; equal strings under str_mem_case_equals
+ * have equal str_mem_case_hash values.
+ */
+void str_mem_lower(char *dest, const char *src, size_t len);
+void str_mem_upper(char *dest, const char *src, size_t len);
+bool str_mem_case_equals(const char *s1, const char *s2, size_t len);
+uint64_t str_mem_case_hash(const char *str, size_t len);
+uint64_t str_case_hash(const char *str);
+
 /* Number conversion */
 int str_to_int(const char *str);
 long str_to_long(const char *str);
@@ -70,6 +86,38 @@ char *int_to_str(int num);
 char *long_to_str(long num);
 char *double_to_str(double num, int precision);
 
+/*
+ * Number parsing over at most len bytes (no NUL needed). Each returns the
+ * number of bytes consumed, 0 if no number starts at str (value is then
+ * left untouched). Out-of-range values saturate and set errno to ERANGE,
+ * as strtol/strtod do; for doubles that includes underflow to zero or to a
+ * subnormal. Doubles are correctly rounded and accept exponents,
+ * inf, infinity and nan.
+ */
+size_t str_parse_int(const char *str, size_t len, int *value);
+size_t str_parse_long(const char *str, size_t len, long *value);
+size_t str_parse_i64(const char *str, size_t len, int64_t *value);
+size_t str_parse_u64(const char *str, size_t len, uint64_t *value);
+size_t str_parse_double(const char *str, size_t len, double *value);
+
+/*
+ * Number formatting into a caller buffer of at least the matching
+ * STR_*_BUFSIZE bytes. The result is NUL-terminated and the return value
+ * is its length. Doubles round-trip: they parse back to the same value,
+ * almost always in the shortest form ("0.1", "1e30", "-2.5e-7"), though
+ * rarely one digit longer. nan / inf are written as str_parse_double
+ * reads them.
+ */
+#define STR_INT_BUFSIZE 12
+#define STR_I64_BUFSIZE 21
+#define STR_DOUBLE_BUFSIZE 32
+
+size_t str_format_int(char *buf, int value);
+size_t str_format_long(char *buf, long value);
+size_t str_format_i64(char *buf, int64_t value);
+size_t str_format_u64(char *buf, uint64_t value);
+size_t str_format_double(char *buf, double value);
+
 /* String validation */
 bool str_is_alpha(const char *str);
 bool str_is_digit(const char *str);
@@ -83,4 +131,20 @@ int str_count_char(const char *str, char c);
 void str_array_free(char **array);
 size_t str_array_len(char **array);
 
+/*
+ * SIMD dispatch: str_len, str_chr, str_cmp, str_count_char, str_span, the
+ * case mapping and case-insensitive functions and the str_is_* validators
+ * use the best kernels the CPU supports, picked when the library is loaded.
+ * str_simd_set_level forces a lower level (tests, benchmarks) and returns
+ * the level actually applied.
+ */
+typedef enum StrSimdLevel {
+	STR_SIMD_SWAR = 0,
+	STR_SIMD_SSE2,
+	STR_SIMD_AVX2,
+} StrSimdLevel;
+
+StrSimdLevel str_simd_level(void);
+StrSimdLevel str_simd_set_level(StrSimdLevel level);
+
 #endif // STRINGS_H
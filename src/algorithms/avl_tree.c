@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 19:53:04 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 19:57:57 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -55,20 +55,25 @@ static AVLNode *rotate_left(AVLNode *x) {
 	return y;
 }
 
-static AVLNode *create_node(const void *key, const void *value, size_t key_size, size_t value_size) {
-	AVLNode *node = malloc(sizeof(AVLNode));
+static void free_node(AVLTree *tree, AVLNode *node) {
+	if (!node) return;
+	if (node->key) allocator_free(&tree->allocator, node->key, tree->key_size);
+	free(node->value);
+	allocator_free(&tree->allocator, node, sizeof(AVLNode));
+}
+
+static AVLNode *create_node(AVLTree *tree, const void *key, const void *value, size_t value_size) {
+	AVLNode *node = allocator_alloc(&tree->allocator, sizeof(AVLNode));
 	if (!node) return NULL;
 
-	node->key	= malloc(key_size);
+	node->key	= allocator_alloc(&tree->allocator, tree->key_size);
 	node->value = malloc(value_size);
 	if (!node->key || !node->value) {
-		free(node->key);
-		free(node->value);
-		free(node);
+		free_node(tree, node);
 		return NULL;
 	}
 
-	memcpy(node->key, key, key_size);
+	memcpy(node->key, key, tree->key_size);
 	memcpy(node->value, value, value_size);
 	node->height = 1;
 	node->left = node->right = NULL;
@@ -98,15 +103,15 @@ static AVLNode *balance_node(AVLNode *node) {
 	return node;
 }
 
-static AVLNode *insert_recursive(AVLNode *node, const void *key, const void *value, size_t key_size, size_t value_size, int (*compare_func)(const void *, const void *)) {
+static AVLNode *insert_recursive(AVLTree *tree, AVLNode *node, const void *key, const void *value, size_t value_size) {
 	if (!node)
-		return create_node(key, value, key_size, value_size);
+		return create_node(tree, key, value, value_size);
 
-	int cmp = compare_func(key, node->key);
+	int cmp = tree->compare_func(key, node->key);
 	if (cmp < 0)
-		node->left = insert_recursive(node->left, key, value, key_size, value_size, compare_func);
+		node->left = insert_recursive(tree, node->left, key, value, value_size);
 	else if (cmp > 0)
-		node->right = insert_recursive(node->right, key, value, key_size, value_size, compare_func);
+		node->right = insert_recursive(tree, node->right, key, value, value_size);
 	else {
 		memcpy(node->value, value, value_size);
 		return node;
@@ -116,18 +121,23 @@ static AVLNode *insert_recursive(AVLNode *node, const void *key, const void *val
 }
 
 int avl_tree_init(AVLTree *tree, size_t key_size, int (*compare_func)(const void *, const void *)) {
+	return avl_tree_init_with_allocator(tree, key_size, compare_func, (Allocator){0});
+}
+
+int avl_tree_init_with_allocator(AVLTree *tree, size_t key_size, int (*compare_func)(const void *, const void *), Allocator allocator) {
 	if (!tree || !compare_func) return -1;
 	tree->root		   = NULL;
 	tree->size		   = 0;
 	tree->key_size	   = key_size;
 	tree->compare_func = compare_func;
+	tree->allocator	   = allocator;
 	return 0;
 }
 
 int avl_tree_insert(AVLTree *tree, const void *key, const void *value, size_t value_size) {
 	if (!tree || !key || !value) return -1;
 
-	tree->root = insert_recursive(tree->root, key, value, tree->key_size, value_size, tree->compare_func);
+	tree->root = insert_recursive(tree, tree->root, key, value, value_size);
 	if (!tree->root) return -1;
 	tree->size++;
 	return 0;
@@ -146,23 +156,16 @@ void *avl_tree_find(AVLTree *tree, const void *key) {
 	return NULL;
 }
 
-static void free_node(AVLNode *node) {
-	if (!node) return;
-	free(node->key);
-	free(node->value);
-	free(node);
-}
-
-static void clear_recursive(AVLNode *node) {
+static void clear_recursive(AVLTree *tree, AVLNode *node) {
 	if (!node) return;
-	clear_recursive(node->left);
-	clear_recursive(node->right);
-	free_node(node);
+	clear_recursive(tree, node->left);
+	clear_recursive(tree, node->right);
+	free_node(tree, node);
 }
 
 void avl_tree_clear(AVLTree *tree) {
 	if (!tree) return;
-	clear_recursive(tree->root);
+	clear_recursive(tree, tree->root);
 	tree->root = NULL;
 	tree->size = 0;
 }
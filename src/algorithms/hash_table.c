@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/31 10:51:00 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/31 10:51:07 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -38,7 +38,17 @@ static bool resize_table(HashTable *table, size_t new_capacity) {
 	return true;
 }
 
+static void destroy_entry(HashTable *table, HashEntry *entry) {
+	allocator_free(&table->allocator, entry->key, table->key_size);
+	free(entry->value);
+	allocator_free(&table->allocator, entry, sizeof(HashEntry));
+}
+
 bool hash_table_init(HashTable *table, size_t initial_capacity, size_t key_size, unsigned int (*hash_func)(const void *key), int (*compare_func)(const void *a, const void *b)) {
+	return hash_table_init_with_allocator(table, initial_capacity, key_size, hash_func, compare_func, (Allocator){0});
+}
+
+bool hash_table_init_with_allocator(HashTable *table, size_t initial_capacity, size_t key_size, unsigned int (*hash_func)(const void *key), int (*compare_func)(const void *a, const void *b), Allocator allocator) {
 	table->buckets = calloc(initial_capacity, sizeof(HashEntry *));
 	if (!table->buckets) return false;
 
@@ -47,6 +57,7 @@ bool hash_table_init(HashTable *table, size_t initial_capacity, size_t key_size,
 	table->key_size		= key_size;
 	table->hash_func	= hash_func;
 	table->compare_func = compare_func;
+	table->allocator	= allocator;
 	return true;
 }
 
@@ -77,15 +88,15 @@ bool hash_table_insert(HashTable *table, const void *key, const void *value, siz
 	}
 
 	// Create new entry
-	HashEntry *new_entry = malloc(sizeof(HashEntry));
+	HashEntry *new_entry = allocator_alloc(&table->allocator, sizeof(HashEntry));
 	if (!new_entry) return false;
 
-	new_entry->key	 = malloc(table->key_size);
+	new_entry->key	 = allocator_alloc(&table->allocator, table->key_size);
 	new_entry->value = malloc(value_size);
 	if (!new_entry->key || !new_entry->value) {
-		free(new_entry->key);
+		if (new_entry->key) allocator_free(&table->allocator, new_entry->key, table->key_size);
 		free(new_entry->value);
-		free(new_entry);
+		allocator_free(&table->allocator, new_entry, sizeof(HashEntry));
 		return false;
 	}
 
@@ -115,9 +126,7 @@ bool hash_table_remove(HashTable *table, const void *key) {
 				table->buckets[index] = current->next;
 			}
 
-			free(current->key);
-			free(current->value);
-			free(current);
+			destroy_entry(table, current);
 			table->size--;
 			return true;
 		}
@@ -156,9 +165,7 @@ void hash_table_clear(HashTable *table) {
 		HashEntry *current = table->buckets[i];
 		while (current) {
 			HashEntry *next = current->next;
-			free(current->key);
-			free(current->value);
-			free(current);
+			destroy_entry(table, current);
 			current = next;
 		}
 		table->buckets[i] = NULL;
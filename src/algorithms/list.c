@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 12:32:32 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 12:34:01 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,14 +16,19 @@
 #include <string.h>
 
 int list_init(List *list) {
-	list->head = NULL;
-	list->tail = NULL;
-	list->size = 0;
+	return list_init_with_allocator(list, (Allocator){0});
+}
+
+int list_init_with_allocator(List *list, Allocator allocator) {
+	list->head		= NULL;
+	list->tail		= NULL;
+	list->size		= 0;
+	list->allocator = allocator;
 	return 0;
 }
 
-static ListNode *create_node(const void *element, size_t element_size) {
-	ListNode *node = malloc(sizeof(ListNode));
+static ListNode *create_node(List *list, const void *element, size_t element_size) {
+	ListNode *node = allocator_alloc(&list->allocator, sizeof(ListNode));
 	if (!node) {
 		fprintf(stderr, "Error: Failed to allocate memory for list node\n");
 		return NULL;
@@ -32,7 +37,7 @@ static ListNode *create_node(const void *element, size_t element_size) {
 	node->data = malloc(element_size);
 	if (!node->data) {
 		fprintf(stderr, "Error: Failed to allocate memory for node data\n");
-		free(node);
+		allocator_free(&list->allocator, node, sizeof(ListNode));
 		return NULL;
 	}
 
@@ -42,8 +47,13 @@ static ListNode *create_node(const void *element, size_t element_size) {
 	return node;
 }
 
+static void destroy_node(List *list, ListNode *node) {
+	free(node->data);
+	allocator_free(&list->allocator, node, sizeof(ListNode));
+}
+
 int list_push_back(List *list, const void *element, size_t element_size) {
-	ListNode *node = create_node(element, element_size);
+	ListNode *node = create_node(list, element, element_size);
 	if (!node) return -1;
 
 	if (list->tail) {
@@ -59,7 +69,7 @@ int list_push_back(List *list, const void *element, size_t element_size) {
 }
 
 int list_push_front(List *list, const void *element, size_t element_size) {
-	ListNode *node = create_node(element, element_size);
+	ListNode *node = create_node(list, element, element_size);
 	if (!node) return -1;
 
 	if (list->head) {
@@ -86,8 +96,7 @@ int list_pop_back(List *list) {
 		list->head = NULL;
 	}
 
-	free(node->data);
-	free(node);
+	destroy_node(list, node);
 	list->size--;
 	return 0;
 }
@@ -104,8 +113,7 @@ int list_pop_front(List *list) {
 		list->tail = NULL;
 	}
 
-	free(node->data);
-	free(node);
+	destroy_node(list, node);
 	list->size--;
 	return 0;
 }
@@ -133,7 +141,7 @@ int list_insert(List *list, size_t index, const void *element, size_t element_si
 	if (index == 0) return list_push_front(list, element, element_size);
 	if (index == list->size) return list_push_back(list, element, element_size);
 
-	ListNode *node = create_node(element, element_size);
+	ListNode *node = create_node(list, element, element_size);
 	if (!node) return -1;
 
 	ListNode *current = list->head;
@@ -167,8 +175,7 @@ int list_erase(List *list, size_t index) {
 	current->prev->next = current->next;
 	current->next->prev = current->prev;
 
-	free(current->data);
-	free(current);
+	destroy_node(list, current);
 	list->size--;
 	return 0;
 }
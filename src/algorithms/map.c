@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 12:39:04 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 12:39:05 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -18,32 +18,42 @@
 #define INITIAL_CAPACITY 16
 #define LOAD_FACTOR_THRESHOLD 0.75
 
-static MapEntry *create_entry(const void *key, size_t key_size, const void *value, size_t value_size) {
-	MapEntry *entry = malloc(sizeof(MapEntry));
+static MapEntry *create_entry(Map *map, const void *key, const void *value, size_t value_size) {
+	MapEntry *entry = allocator_alloc(&map->allocator, sizeof(MapEntry));
 	if (!entry) {
 		return NULL;
 	}
 
-	entry->key = malloc(key_size);
+	entry->key = allocator_alloc(&map->allocator, map->key_size);
 	if (!entry->key) {
-		free(entry);
+		allocator_free(&map->allocator, entry, sizeof(MapEntry));
 		return NULL;
 	}
 
 	entry->value = malloc(value_size);
 	if (!entry->value) {
-		free(entry->key);
-		free(entry);
+		allocator_free(&map->allocator, entry->key, map->key_size);
+		allocator_free(&map->allocator, entry, sizeof(MapEntry));
 		return NULL;
 	}
 
-	memcpy(entry->key, key, key_size);
+	memcpy(entry->key, key, map->key_size);
 	memcpy(entry->value, value, value_size);
 	entry->next = NULL;
 	return entry;
 }
 
+static void destroy_entry(Map *map, MapEntry *entry) {
+	allocator_free(&map->allocator, entry->key, map->key_size);
+	free(entry->value);
+	allocator_free(&map->allocator, entry, sizeof(MapEntry));
+}
+
 int map_init(Map *map, size_t initial_capacity, size_t key_size, size_t (*hash_func)(const void *), int (*compare_func)(const void *, const void *)) {
+	return map_init_with_allocator(map, initial_capacity, key_size, hash_func, compare_func, (Allocator){0});
+}
+
+int map_init_with_allocator(Map *map, size_t initial_capacity, size_t key_size, size_t (*hash_func)(const void *), int (*compare_func)(const void *, const void *), Allocator allocator) {
 	if (initial_capacity == 0) {
 		initial_capacity = INITIAL_CAPACITY;
 	}
@@ -58,6 +68,7 @@ int map_init(Map *map, size_t initial_capacity, size_t key_size, size_t (*hash_f
 	map->key_size	  = key_size;
 	map->hash_func	  = hash_func;
 	map->compare_func = compare_func;
+	map->allocator	  = allocator;
 	return 0;
 }
 
@@ -112,7 +123,7 @@ int map_insert(Map *map, const void *key, const void *value, size_t value_size)
 	}
 
 	// Create new entry
-	MapEntry *new_entry = create_entry(key, map->key_size, value, value_size);
+	MapEntry *new_entry = create_entry(map, key, value, value_size);
 	if (!new_entry) {
 		return -1;
 	}
@@ -150,9 +161,7 @@ int map_erase(Map *map, const void *key) {
 				map->buckets[index] = entry->next;
 			}
 
-			free(entry->key);
-			free(entry->value);
-			free(entry);
+			destroy_entry(map, entry);
 			map->size--;
 			return 0;
 		}
@@ -180,9 +189,7 @@ void map_clear(Map *map) {
 		MapEntry *entry = map->buckets[i];
 		while (entry) {
 			MapEntry *next = entry->next;
-			free(entry->key);
-			free(entry->value);
-			free(entry);
+			destroy_entry(map, entry);
 			entry = next;
 		}
 		map->buckets[i] = NULL;
@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 12:40:31 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 21:14:19 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,20 +14,25 @@
 #include <stdlib.h>
 #include <string.h>
 
-static RBNode *create_node(const void *key, const void *value, size_t key_size, size_t value_size) {
-	RBNode *node = malloc(sizeof(RBNode));
+static void free_node(RBTree *tree, RBNode *node) {
+	if (!node) return;
+	if (node->key) allocator_free(&tree->allocator, node->key, tree->key_size);
+	free(node->value);
+	allocator_free(&tree->allocator, node, sizeof(RBNode));
+}
+
+static RBNode *create_node(RBTree *tree, const void *key, const void *value, size_t value_size) {
+	RBNode *node = allocator_alloc(&tree->allocator, sizeof(RBNode));
 	if (!node) return NULL;
 
-	node->key	= malloc(key_size);
+	node->key	= allocator_alloc(&tree->allocator, tree->key_size);
 	node->value = malloc(value_size);
 	if (!node->key || !node->value) {
-		free(node->key);
-		free(node->value);
-		free(node);
+		free_node(tree, node);
 		return NULL;
 	}
 
-	memcpy(node->key, key, key_size);
+	memcpy(node->key, key, tree->key_size);
 	memcpy(node->value, value, value_size);
 	node->color	 = RB_RED;
 	node->parent = node->left = node->right = NULL;
@@ -106,16 +111,21 @@ static void fix_insert(RBTree *tree, RBNode *node) {
 }
 
 int rb_tree_init(RBTree *tree, size_t key_size, int (*compare_func)(const void *, const void *)) {
+	return rb_tree_init_with_allocator(tree, key_size, compare_func, (Allocator){0});
+}
+
+int rb_tree_init_with_allocator(RBTree *tree, size_t key_size, int (*compare_func)(const void *, const void *), Allocator allocator) {
 	if (!tree || !compare_func) return -1;
 	tree->root		   = NULL;
 	tree->size		   = 0;
 	tree->key_size	   = key_size;
 	tree->compare_func = compare_func;
+	tree->allocator	   = allocator;
 	return 0;
 }
 
 int rb_tree_insert(RBTree *tree, const void *key, const void *value, size_t value_size) {
-	RBNode *new_node = create_node(key, value, tree->key_size, value_size);
+	RBNode *new_node = create_node(tree, key, value, value_size);
 	if (!new_node) return -1;
 
 	RBNode *parent	= NULL;
@@ -130,9 +140,7 @@ int rb_tree_insert(RBTree *tree, const void *key, const void *value, size_t valu
 			current = current->right;
 		else {
 			memcpy(current->value, value, value_size);
-			free(new_node->key);
-			free(new_node->value);
-			free(new_node);
+			free_node(tree, new_node);
 			return 0;
 		}
 	}
@@ -164,13 +172,6 @@ void *rb_tree_find(RBTree *tree, const void *key) {
 	return NULL;
 }
 
-static void free_node(RBNode *node) {
-	if (!node) return;
-	free(node->key);
-	free(node->value);
-	free(node);
-}
-
 void rb_tree_clear(RBTree *tree) {
 	if (!tree) return;
 
@@ -178,7 +179,7 @@ void rb_tree_clear(RBTree *tree) {
 	while (current) {
 		if (!current->left) {
 			RBNode *right = current->right;
-			free_node(current);
+			free_node(tree, current);
 			current = right;
 		} else {
 			RBNode *left  = current->left;
@@ -188,6 +189,7 @@ void rb_tree_clear(RBTree *tree) {
 			left->right		= current;
 			left->parent	= current->parent;
 			current->parent = left;
+			current			= left;
 		}
 	}
 	tree->root = NULL;
@@ -329,7 +331,7 @@ int rb_tree_remove(RBTree *tree, const void *key) {
 		// Pour la simplicité, elle est omise ici
 	}
 
-	free_node(node);
+	free_node(tree, node);
 	tree->size--;
 	return 0;
 }
@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 20:02:23 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 20:54:00 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -20,9 +20,19 @@ static int random_level(void) {
 	return level;
 }
 
-static SkipNode *create_node(int level, int key, void *value) {
-	SkipNode *node = malloc(sizeof(SkipNode));
-	node->forward  = malloc(sizeof(SkipNode *) * (level + 1));
+static void destroy_node(SkipList *list, SkipNode *node) {
+	allocator_free(&list->allocator, node->forward, sizeof(SkipNode *) * (node->level + 1));
+	allocator_free(&list->allocator, node, sizeof(SkipNode));
+}
+
+static SkipNode *create_node(SkipList *list, int level, int key, void *value) {
+	SkipNode *node = allocator_alloc(&list->allocator, sizeof(SkipNode));
+	if (!node) return NULL;
+	node->forward = allocator_alloc(&list->allocator, sizeof(SkipNode *) * (level + 1));
+	if (!node->forward) {
+		allocator_free(&list->allocator, node, sizeof(SkipNode));
+		return NULL;
+	}
 	node->key	   = key;
 	node->value	   = value;
 	node->level	   = level;
@@ -30,10 +40,20 @@ static SkipNode *create_node(int level, int key, void *value) {
 }
 
 SkipList *skip_list_create(void) {
+	return skip_list_create_with_allocator((Allocator){0});
+}
+
+SkipList *skip_list_create_with_allocator(Allocator allocator) {
 	SkipList *list = malloc(sizeof(SkipList));
-	list->level	   = 1;
-	list->size	   = 0;
-	list->header   = create_node(MAX_LEVEL, -1, NULL); // Set value to NULL
+	if (!list) return NULL;
+	list->level		= 1;
+	list->size		= 0;
+	list->allocator = allocator;
+	list->header	= create_node(list, MAX_LEVEL, -1, NULL); // Set value to NULL
+	if (!list->header) {
+		free(list);
+		return NULL;
+	}
 	for (int i = 0; i <= MAX_LEVEL; i++) {
 		list->header->forward[i] = NULL;
 	}
@@ -44,8 +64,7 @@ void skip_list_destroy(SkipList *list) {
 	SkipNode *current = list->header;
 	while (current) {
 		SkipNode *next = current->forward[0];
-		free(current->forward);
-		free(current);
+		destroy_node(list, current);
 		current = next;
 	}
 	free(list);
@@ -76,7 +95,8 @@ int skip_list_insert(SkipList *list, int key, void *value) {
 		list->level = new_level;
 	}
 
-	SkipNode *new_node = create_node(new_level, key, value);
+	SkipNode *new_node = create_node(list, new_level, key, value);
+	if (!new_node) return -1;
 	for (int i = 0; i < new_level; i++) {
 		new_node->forward[i]  = update[i]->forward[i];
 		update[i]->forward[i] = new_node;
@@ -128,8 +148,7 @@ int skip_list_delete(SkipList *list, int key) {
 		list->level--;
 	}
 
-	free(current->forward);
-	free(current);
+	destroy_node(list, current);
 	list->size--;
 	return 1;
 }
@@ -6,77 +6,1234 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   */
 /*   Created: 2025/01/30 11:11:47 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 11:32:09 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <lib/garbage.h>
 
-#include <stdarg.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Internal structure for allocation tracking.
+ */
+typedef struct GarbageManager {
+	GarbageContext context; /**< Garbage manager context */
+} GarbageManager;
+
+static GarbageManager manager = {0};
+
+#define INDEX_MIN_CAPACITY 64
+
+/**
+ * @brief Size of the header in front of each user block in embedded mode,
+ * rounded up so the user data keeps malloc's alignment.
+ */
+#define EMBEDDED_HEADER_SIZE \
+	((sizeof(MemoryBlock) + _Alignof(max_align_t) - 1) / _Alignof(max_align_t) * _Alignof(max_align_t))
+
+/**
+ * @brief Chunk of arena memory; blocks are carved from data upwards.
+ */
+struct GarbageChunk {
+	GarbageChunk *prev; /**< Next older chunk */
+	size_t size;		/**< Capacity of data */
+	size_t used;		/**< Bytes handed out */
+	max_align_t data[]; /**< Block storage */
+};
+
+#define ARENA_ALIGN _Alignof(max_align_t)
+
+/**
+ * @brief Counters of one size class or call site.
+ */
+typedef struct GarbageCounters {
+	size_t allocations; /**< Blocks allocated */
+	size_t frees;		/**< Blocks freed */
+	size_t bytes;		/**< Bytes allocated */
+	size_t live_bytes;	/**< Bytes allocated and not freed yet */
+} GarbageCounters;
+
+struct GarbageSite {
+	const void *key; /**< Return address or tag string, NULL if free */
+	bool tagged;	 /**< key is a garbage_profile_tag() string */
+};
+
+/**
+ * @brief Profile counters of one context, or of one thread cache of a
+ * shared context. Updated under the lock that guards that context's list.
+ */
+struct GarbageCounterSet {
+	GarbageCounters total;							  /**< Every profiled block */
+	size_t peak_bytes;								  /**< Highest total.live_bytes seen */
+	size_t rate_bytes;								  /**< total.bytes already in the rate totals */
+	GarbageCounters classes[GC_PROFILE_SIZE_CLASSES]; /**< Per log2 size class */
+	GarbageCounters sites[GC_PROFILE_MAX_SITES + 1];  /**< Per site slot, "other" last */
+};
+
+/**
+ * @brief Allocation-rate sample: cumulative totals at a point in time.
+ */
+typedef struct GarbageRateSample {
+	uint64_t elapsed_ns; /**< Time since profiling started */
+	size_t allocations;	 /**< Allocations so far */
+	size_t bytes;		 /**< Bytes allocated so far */
+} GarbageRateSample;
+
+/**
+ * @brief Allocation profile of a context.
+ *
+ * Counting goes to the counter set of the context that links the block:
+ * the context itself, or the thread cache of a shared context. Threads
+ * therefore never write the same counter, and the cache lock they already
+ * hold makes plain adds safe; dumps sum the caches. Only the site table,
+ * whose slots are claimed with a compare-and-swap, and the rate ring are
+ * shared.
+ */
+struct GarbageProfile {
+	GarbageCounterSet counters;						 /**< Counters of an unshared context */
+	GarbageSite sites[GC_PROFILE_MAX_SITES];		 /**< Open-addressing table by key */
+	GarbageSite other;								 /**< Sites that did not fit */
+	struct timespec start;							 /**< When profiling started */
+	pthread_mutex_t rate_lock;						 /**< Guards the rate ring and totals */
+	GarbageRateSample rate[GC_PROFILE_RATE_SAMPLES]; /**< Ring of rate samples */
+	size_t rate_count;								 /**< Samples taken so far */
+	size_t rate_allocations;						 /**< Allocations in the rate totals */
+	size_t rate_bytes;								 /**< Bytes in the rate totals */
+};
+
+/** Probes before a new site is counted as "other" */
+#define PROFILE_MAX_PROBES 64
+
+/**
+ * @brief Site of the allocation in progress on this thread, set by the
+ * outermost gc_* call on a profiled context.
+ */
+static _Thread_local const void *alloc_site;
+static _Thread_local bool alloc_site_tagged;
+static _Thread_local const char *profile_tag;
+
+typedef struct GarbageCache GarbageCache;
+
+/**
+ * @brief Registry of the thread caches of a shared context.
+ */
+struct GarbageThreads {
+	pthread_key_t key;	  /**< Calling thread's GarbageCache */
+	pthread_mutex_t lock; /**< Guards the cache list and the attached flags */
+	GarbageCache *caches; /**< Every cache, attached or not */
+	GarbageMode mode;	  /**< Mode of the cache contexts */
+	bool verbose_mode;	  /**< Verbose mode of the cache contexts */
+};
+
+/**
+ * @brief Context of one thread. Its lock is only contended when another
+ * thread frees one of its blocks or reads its statistics.
+ */
+struct GarbageCache {
+	GarbageContext context;	 /**< First, so a block's owner leads back here */
+	pthread_mutex_t lock;	 /**< Guards context */
+	GarbageThreads *threads; /**< Registry the cache belongs to */
+	GarbageCache *next;		 /**< Next cache in the registry */
+	bool attached;			 /**< In use by a live thread */
+};
+
+/**
+ * @brief Initializes a new context for allocation tracking.
+ *
+ * This function is called by garbage_init().
+ */
+static void initialize_context(GarbageContext *ctx) {
+	ctx->total_allocations		= 0;
+	ctx->total_frees			= 0;
+	ctx->current_allocated_size = 0;
+	ctx->head					= NULL;
+	ctx->tail					= NULL;
+	ctx->index					= NULL;
+	ctx->index_capacity			= 0;
+	ctx->index_count			= 0;
+	ctx->chunks					= NULL;
+	ctx->spare					= NULL;
+	ctx->profile				= NULL;
+	ctx->counters				= NULL;
+}
+
+/**
+ * @brief Prints a message if verbose mode is enabled.
+ */
+static void verbose_printf(const GarbageContext *ctx, const char *format, ...) {
+	if (ctx->verbose_mode) {
+		va_list args;
+		va_start(args, format);
+		vprintf(format, args);
+		va_end(args);
+	}
+}
+
+/**
+ * @brief Home slot of a pointer in the block index.
+ *
+ * Allocator addresses share their low bits, so they are mixed with a
+ * multiplicative hash before masking.
+ */
+static size_t index_home(const GarbageContext *ctx, const void *ptr) {
+	uint64_t h = (uint64_t)(uintptr_t)ptr * 0x9E3779B97F4A7C15ULL;
+	return (size_t)(h >> 32 ^ h) & (ctx->index_capacity - 1);
+}
+
+/**
+ * @brief Slot holding ptr, or the empty slot where the probe stopped.
+ */
+static size_t index_slot(const GarbageContext *ctx, const void *ptr) {
+	size_t mask = ctx->index_capacity - 1;
+	size_t i	= index_home(ctx, ptr);
+
+	while (ctx->index[i] != NULL && ctx->index[i]->ptr != ptr)
+		i = (i + 1) & mask;
+	return i;
+}
+
+/**
+ * @brief Doubles the index (or creates it), keeping the load under 3/4.
+ */
+static bool index_grow(GarbageContext *ctx) {
+	size_t old_capacity	 = ctx->index_capacity;
+	MemoryBlock **old	 = ctx->index;
+	size_t new_capacity	 = old_capacity ? old_capacity * 2 : INDEX_MIN_CAPACITY;
+	MemoryBlock **resized = calloc(new_capacity, sizeof(MemoryBlock *));
+
+	if (resized == NULL)
+		return false;
+	ctx->index			= resized;
+	ctx->index_capacity = new_capacity;
+	for (size_t i = 0; i < old_capacity; i++)
+		if (old[i] != NULL)
+			ctx->index[index_slot(ctx, old[i]->ptr)] = old[i];
+	free(old);
+	return true;
+}
+
+/**
+ * @brief Empties a slot, shifting back the entries probed past it.
+ *
+ * Backward-shift deletion keeps probe sequences unbroken without
+ * tombstones, so lookups never slow down after many frees.
+ */
+static void index_erase(GarbageContext *ctx, size_t slot) {
+	size_t mask = ctx->index_capacity - 1;
+	size_t i	= slot;
+
+	for (size_t j = (i + 1) & mask; ctx->index[j] != NULL; j = (j + 1) & mask) {
+		size_t home = index_home(ctx, ctx->index[j]->ptr);
+		// The entry at j may move to i if its home is not in (i, j]
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			ctx->index[i] = ctx->index[j];
+			i			  = j;
+		}
+	}
+	ctx->index[i] = NULL;
+	ctx->index_count--;
+}
+
+/**
+ * @brief Log2 size class: the bit width of size, capped.
+ */
+static size_t profile_class(size_t size) {
+	size_t width = size ? (size_t)(64 - __builtin_clzll((unsigned long long)size)) : 0;
+	return (width < GC_PROFILE_SIZE_CLASSES) ? width : GC_PROFILE_SIZE_CLASSES - 1;
+}
+
+/**
+ * @brief Counters of a site, claiming a free slot for a new one.
+ *
+ * Slots are claimed with a compare-and-swap, so threads sharing the
+ * profile never lock; after PROFILE_MAX_PROBES busy slots the site is
+ * counted as "other".
+ */
+static GarbageSite *profile_site(GarbageProfile *profile, const void *key, bool tagged) {
+	if (key == NULL) {
+		return &profile->other;
+	}
+
+	uint64_t h	= (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ULL;
+	size_t mask = GC_PROFILE_MAX_SITES - 1;
+	size_t i	= (size_t)(h >> 32 ^ h) & mask;
+
+	for (size_t probe = 0; probe < PROFILE_MAX_PROBES; probe++, i = (i + 1) & mask) {
+		GarbageSite *site = &profile->sites[i];
+		const void *found = __atomic_load_n(&site->key, __ATOMIC_ACQUIRE);
+
+		if (found == NULL &&
+			__atomic_compare_exchange_n(&site->key, &found, key, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			__atomic_store_n(&site->tagged, tagged, __ATOMIC_RELAXED);
+			return site;
+		}
+		if (found == key) {
+			return site;
+		}
+	}
+	return &profile->other;
+}
+
+/**
+ * @brief Counters of a site in a counter set.
+ */
+static GarbageCounters *site_counters(GarbageProfile *profile, GarbageCounterSet *set, const GarbageSite *site) {
+	return &set->sites[(site == &profile->other) ? GC_PROFILE_MAX_SITES : (size_t)(site - profile->sites)];
+}
+
+/**
+ * @brief Adds a stride of the set's allocations to the rate totals and
+ * records them. In a shared context the totals advance by whole strides
+ * of one thread at a time, so they trail the exact ones by less than a
+ * stride per thread.
+ */
+static void profile_rate_sample(GarbageProfile *profile, GarbageCounterSet *set) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	int64_t elapsed = (int64_t)(now.tv_sec - profile->start.tv_sec) * 1000000000 + (now.tv_nsec - profile->start.tv_nsec);
+
+	pthread_mutex_lock(&profile->rate_lock);
+	profile->rate_allocations += GC_PROFILE_RATE_STRIDE;
+	profile->rate_bytes += set->total.bytes - set->rate_bytes;
+	set->rate_bytes = set->total.bytes;
+
+	GarbageRateSample *sample = &profile->rate[profile->rate_count++ % GC_PROFILE_RATE_SAMPLES];
+	sample->elapsed_ns		  = (uint64_t)elapsed;
+	sample->allocations		  = profile->rate_allocations;
+	sample->bytes			  = profile->rate_bytes;
+	pthread_mutex_unlock(&profile->rate_lock);
+}
+
+/**
+ * @brief Counts a new block in set and returns the site it is attributed to.
+ */
+static GarbageSite *profile_alloc(GarbageProfile *profile, GarbageCounterSet *set, size_t size) {
+	GarbageSite *site			= profile_site(profile, alloc_site, alloc_site_tagged);
+	GarbageCounters *counters[] = {&set->total, &set->classes[profile_class(size)], site_counters(profile, set, site)};
+
+	for (size_t i = 0; i < sizeof(counters) / sizeof(*counters); i++) {
+		counters[i]->allocations++;
+		counters[i]->bytes += size;
+		counters[i]->live_bytes += size;
+	}
+	if (set->total.live_bytes > set->peak_bytes) {
+		set->peak_bytes = set->total.live_bytes;
+	}
+	if ((set->total.allocations & (GC_PROFILE_RATE_STRIDE - 1)) == 0) {
+		profile_rate_sample(profile, set);
+	}
+	return site;
+}
+
+/**
+ * @brief Uncounts a freed block from set, if it was allocated while profiling.
+ */
+static void profile_free(GarbageProfile *profile, GarbageCounterSet *set, const MemoryBlock *block) {
+	if (block->site == NULL) {
+		return;
+	}
+
+	GarbageCounters *counters[] = {&set->total, &set->classes[profile_class(block->size)],
+								   site_counters(profile, set, block->site)};
+	for (size_t i = 0; i < sizeof(counters) / sizeof(*counters); i++) {
+		counters[i]->frees++;
+		counters[i]->live_bytes -= block->size;
+	}
+}
+
+static void profile_destroy(GarbageProfile *profile) {
+	if (profile != NULL) {
+		pthread_mutex_destroy(&profile->rate_lock);
+		free(profile);
+	}
+}
+
+/**
+ * @brief Names the site of an allocation made by the outermost gc_* call
+ * on a profiled context: the thread's tag, else the caller's address.
+ */
+static void profile_enter(const void *return_address) {
+	alloc_site		  = profile_tag ? (const void *)profile_tag : return_address;
+	alloc_site_tagged = profile_tag != NULL;
+}
+
+/**
+ * @brief Whether the context records blocks in the pointer index.
+ */
+static bool uses_index(const GarbageContext *ctx) {
+	return ctx->mode == GC_MODE_INDEXED || ctx->mode == GC_MODE_SAMPLED;
+}
+
+/**
+ * @brief log2(x) for x >= 1, to about 1e-6, without libm.
+ *
+ * The exponent comes from the bits of x; log of the mantissa m in [1, 2)
+ * from the series 2 atanh((m - 1) / (m + 1)).
+ */
+static double sampler_log2(double x) {
+	uint64_t bits;
+
+	memcpy(&bits, &x, sizeof(bits));
+	int exponent = (int)((bits >> 52) & 0x7FF) - 1023;
+	bits		 = (bits & ((1ULL << 52) - 1)) | (1023ULL << 52);
+
+	double m;
+	memcpy(&m, &bits, sizeof(m));
+	double t  = (m - 1) / (m + 1);
+	double t2 = t * t;
+	double ln = 2 * t * (1 + t2 * (1.0 / 3 + t2 * (1.0 / 5 + t2 * (1.0 / 7 + t2 * (1.0 / 9)))));
+	return exponent + ln * 1.4426950408889634;
+}
+
+/**
+ * @brief 1 - exp(-x) for x >= 0, without libm.
+ *
+ * exp(-x) = 2^-k * exp(-f ln 2) with k integer and f in [0, 1); small x
+ * use the series directly to avoid cancellation.
+ */
+static double sampler_probability(double x) {
+	if (x < 1e-3) {
+		return x * (1 - x * (0.5 - x * (1.0 / 6 - x / 24)));
+	}
+
+	double y = x * 1.4426950408889634;
+	if (y >= 1022) {
+		return 1;
+	}
+
+	int k	 = (int)y;
+	double z = (y - k) * 0.6931471805599453;
+	double e = 1, term = 1;
+	for (int n = 1; n <= 12; n++) {
+		term *= -z / n;
+		e += term;
+	}
+
+	uint64_t bits = (uint64_t)(1023 - k) << 52;
+	double scale;
+	memcpy(&scale, &bits, sizeof(scale));
+	return 1 - e * scale;
+}
+
+/**
+ * @brief Bytes until the next sample: an exponential draw of mean
+ * sample_period, from 26 random bits as tcmalloc does.
+ */
+static size_t sampler_interval(GarbageContext *ctx) {
+	// xorshift64*
+	ctx->sample_state ^= ctx->sample_state >> 12;
+	ctx->sample_state ^= ctx->sample_state << 25;
+	ctx->sample_state ^= ctx->sample_state >> 27;
+	uint64_t random = ctx->sample_state * 0x2545F4914F6CDD1DULL;
+
+	double q		= (double)(random >> 38) + 1.0; // Uniform in [1, 2^26]
+	double interval = (26 - sampler_log2(q)) * 0.6931471805599453 * (double)ctx->sample_period;
+	return (interval < 1) ? 1 : (size_t)interval;
+}
+
+static void sampler_seed(GarbageContext *ctx, uint64_t seed) {
+	// splitmix64 finaliser: nearby seeds give unrelated xorshift states
+	seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+	ctx->sample_state		= (seed ^ (seed >> 31)) | 1;
+	ctx->bytes_until_sample = ctx->sample_period ? sampler_interval(ctx) : 0;
+}
+
+static void sampler_init(GarbageContext *ctx, size_t period) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ctx->sample_period = period;
+	sampler_seed(ctx, (uint64_t)(uintptr_t)ctx ^ (uint64_t)now.tv_nsec * 0x9E3779B97F4A7C15ULL);
+}
+
+/**
+ * @brief Whether an allocation of size bytes is sampled.
+ *
+ * Counting the allocated bytes down to the next exponential draw picks
+ * each byte with probability 1 / sample_period, independently.
+ */
+static bool sampler_hit(GarbageContext *ctx, size_t size) {
+	if (size < ctx->bytes_until_sample) {
+		ctx->bytes_until_sample -= size;
+		return false;
+	}
+	ctx->bytes_until_sample = sampler_interval(ctx);
+	return true;
+}
+
+/**
+ * @brief Number of blocks a recorded block stands for.
+ */
+static double sampler_weight(const GarbageContext *ctx, size_t size) {
+	if (ctx->mode != GC_MODE_SAMPLED) {
+		return 1;
+	}
+	return 1 / sampler_probability((double)(size ? size : 1) / (double)ctx->sample_period);
+}
+
+/**
+ * @brief Appends a block to the list and counts it as allocated.
+ */
+static void link_block(GarbageContext *ctx, MemoryBlock *block) {
+	block->prev = ctx->tail;
+	block->next = NULL;
+
+	if (ctx->head == NULL) {
+		ctx->head = block;
+	} else {
+		ctx->tail->next = block;
+	}
+
+	ctx->tail	 = block;
+	block->owner = ctx;
+	block->site	 = ctx->profile ? profile_alloc(ctx->profile, ctx->counters, block->size) : NULL;
+	ctx->current_allocated_size += block->size;
+	ctx->total_allocations++;
+
+	verbose_printf(ctx, "New allocation:\n");
+	verbose_printf(ctx, "- Pointer: %p\n", block->ptr);
+	verbose_printf(ctx, "- Size: %zu bytes\n", block->size);
+}
+
+/**
+ * @brief Takes a block out of the list and its size out of the total.
+ *
+ * Only the neighbours and the list ends are written, so this also works
+ * for a block whose header realloc() has just moved.
+ */
+static void unlink_block(GarbageContext *ctx, MemoryBlock *block) {
+	if (block->prev != NULL) {
+		block->prev->next = block->next;
+	} else {
+		ctx->head = block->next;
+	}
+
+	if (block->next != NULL) {
+		block->next->prev = block->prev;
+	} else {
+		ctx->tail = block->prev;
+	}
+
+	if (ctx->profile != NULL) {
+		profile_free(ctx->profile, ctx->counters, block);
+	}
+	ctx->current_allocated_size -= block->size;
+}
+
+/**
+ * @brief Unlinks a block from the list and the index and frees the record.
+ */
+static void detach_block(GarbageContext *ctx, MemoryBlock *block, size_t slot) {
+	unlink_block(ctx, block);
+	index_erase(ctx, slot);
+	free(block);
+}
+
+/**
+ * @brief Header of a block allocated in embedded mode.
+ */
+static MemoryBlock *embedded_header(void *ptr) {
+	return (MemoryBlock *)((char *)ptr - EMBEDDED_HEADER_SIZE);
+}
+
+/**
+ * @brief One allocation holding the header and the user block.
+ *
+ * The header is the list node, so tracking costs no extra malloc and no
+ * clock read (allocation_time stays 0).
+ */
+static void *embedded_alloc(GarbageContext *ctx, size_t size, bool zero) {
+	if (size > SIZE_MAX - EMBEDDED_HEADER_SIZE) {
+		return NULL;
+	}
+
+	MemoryBlock *block = zero ? calloc(1, EMBEDDED_HEADER_SIZE + size) : malloc(EMBEDDED_HEADER_SIZE + size);
+	if (block == NULL) {
+		return NULL;
+	}
+
+	block->ptr			   = (char *)block + EMBEDDED_HEADER_SIZE;
+	block->size			   = size;
+	block->allocation_time = 0;
+	link_block(ctx, block);
+	return block->ptr;
+}
+
+/**
+ * @brief Frees an embedded-mode block: no lookup, the header is in front.
+ *
+ * The header is trusted, so ptr must be a live block of this context.
+ */
+static void embedded_free(GarbageContext *ctx, void *ptr) {
+	MemoryBlock *block = embedded_header(ptr);
+
+	verbose_printf(ctx, "Block freed:\n");
+	verbose_printf(ctx, "- Pointer: %p\n", ptr);
+
+	unlink_block(ctx, block);
+	ctx->total_frees++;
+	free(block);
+}
+
+/**
+ * @brief Resizes an embedded-mode block; it moves to the list tail, as a
+ * free plus a new allocation would in indexed mode.
+ */
+static void *embedded_realloc(GarbageContext *ctx, void *ptr, size_t size) {
+	MemoryBlock *block = embedded_header(ptr);
+
+	if (size == 0) {
+		embedded_free(ctx, ptr);
+		return NULL;
+	}
+	if (size > SIZE_MAX - EMBEDDED_HEADER_SIZE) {
+		return NULL;
+	}
+
+	MemoryBlock *moved = realloc(block, EMBEDDED_HEADER_SIZE + size);
+	if (moved == NULL) {
+		return NULL;
+	}
+
+	// The neighbours still point at the old header: relink from the copy
+	unlink_block(ctx, moved);
+	ctx->total_frees++;
+	moved->ptr	= (char *)moved + EMBEDDED_HEADER_SIZE;
+	moved->size = size;
+	link_block(ctx, moved);
+	return moved->ptr;
+}
+
+/**
+ * @brief Makes a chunk of at least min bytes the newest one.
+ *
+ * The spare chunk left by a rewind is reused when it is large enough, so
+ * a loop that rewinds once per iteration stops calling malloc.
+ */
+static GarbageChunk *arena_push_chunk(GarbageContext *ctx, size_t min) {
+	size_t size			= (min > ctx->chunk_size) ? min : ctx->chunk_size;
+	GarbageChunk *chunk = ctx->spare;
+
+	if (chunk != NULL && chunk->size >= size) {
+		ctx->spare = NULL;
+	} else {
+		if (size > SIZE_MAX - sizeof(GarbageChunk)) {
+			return NULL;
+		}
+		chunk = malloc(sizeof(GarbageChunk) + size);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		chunk->size = size;
+	}
+
+	chunk->used = 0;
+	chunk->prev = ctx->chunks;
+	ctx->chunks = chunk;
+	return chunk;
+}
+
+/**
+ * @brief Releases the newest chunk, keeping one regular chunk as spare.
+ */
+static void arena_pop_chunk(GarbageContext *ctx) {
+	GarbageChunk *chunk = ctx->chunks;
+
+	ctx->chunks = chunk->prev;
+	if (ctx->spare == NULL && chunk->size == ctx->chunk_size) {
+		ctx->spare = chunk;
+	} else {
+		free(chunk);
+	}
+}
+
+/**
+ * @brief Frees every chunk, the spare one included.
+ */
+static void arena_release(GarbageContext *ctx) {
+	while (ctx->chunks != NULL) {
+		arena_pop_chunk(ctx);
+	}
+	free(ctx->spare);
+	ctx->spare = NULL;
+}
+
+static void *arena_alloc(GarbageContext *ctx, size_t size, bool zero) {
+	GarbageChunk *chunk = ctx->chunks;
+
+	if (size > SIZE_MAX - ARENA_ALIGN) {
+		return NULL;
+	}
+
+	// Zero-sized requests still get a distinct pointer
+	size_t rounded = (size ? size + ARENA_ALIGN - 1 : ARENA_ALIGN) / ARENA_ALIGN * ARENA_ALIGN;
+	if (chunk == NULL || chunk->size - chunk->used < rounded) {
+		chunk = arena_push_chunk(ctx, rounded);
+		if (chunk == NULL) {
+			return NULL;
+		}
+	}
+
+	void *ptr = (char *)chunk->data + chunk->used;
+	chunk->used += rounded;
+	ctx->current_allocated_size += size;
+	ctx->total_allocations++;
+	if (zero) {
+		memset(ptr, 0, size);
+	}
+	return ptr;
+}
+
+/**
+ * @brief Copies a block into a new allocation of size bytes.
+ *
+ * Block sizes are not recorded, so the copy stops at the end of the used
+ * part of the chunk holding ptr, which never reads outside that chunk.
+ */
+static void *arena_realloc(GarbageContext *ctx, void *ptr, size_t size) {
+	uintptr_t addr	 = (uintptr_t)ptr;
+	size_t available = 0;
+	bool found		 = false;
+
+	for (GarbageChunk *chunk = ctx->chunks; chunk != NULL && !found; chunk = chunk->prev) {
+		uintptr_t data = (uintptr_t)chunk->data;
+		if (addr >= data && addr < data + chunk->used) {
+			available = data + chunk->used - addr;
+			found	  = true;
+		}
+	}
+	if (!found) {
+		fprintf(stderr, "Error: Block not found in list.\n");
+		return NULL;
+	}
+	if (size == 0) {
+		return NULL; // Freed, as far as an arena frees anything
+	}
+
+	void *new_ptr = arena_alloc(ctx, size, false);
+	if (new_ptr != NULL) {
+		memcpy(new_ptr, ptr, (size < available) ? size : available);
+	}
+	return new_ptr;
+}
+
+/**
+ * @brief Thread exit: the cache stays registered with its blocks and is
+ * handed to the next thread that needs one.
+ */
+static void cache_detach(void *arg) {
+	GarbageCache *cache = arg;
+
+	pthread_mutex_lock(&cache->threads->lock);
+	cache->attached = false;
+	pthread_mutex_unlock(&cache->threads->lock);
+}
+
+/**
+ * @brief Calling thread's cache, adopting a detached one or creating it.
+ */
+static GarbageCache *own_cache(GarbageContext *ctx) {
+	GarbageThreads *threads = ctx->threads;
+	GarbageCache *cache		= pthread_getspecific(threads->key);
+
+	if (cache != NULL) {
+		return cache;
+	}
+
+	pthread_mutex_lock(&threads->lock);
+	for (cache = threads->caches; cache != NULL && cache->attached; cache = cache->next)
+		;
+	if (cache == NULL) {
+		cache = malloc(sizeof(GarbageCache));
+		if (cache != NULL) {
+			initialize_context(&cache->context);
+			cache->context.mode			= threads->mode;
+			cache->context.chunk_size	= GC_ARENA_CHUNK_SIZE;
+			cache->context.threads		= NULL;
+			cache->context.verbose_mode	= threads->verbose_mode;
+			cache->context.profile		= ctx->profile;
+			cache->context.counters		= ctx->profile ? calloc(1, sizeof(GarbageCounterSet)) : NULL;
+			sampler_init(&cache->context, 0);
+			if (ctx->profile != NULL && cache->context.counters == NULL) {
+				free(cache);
+				cache = NULL;
+			}
+		}
+		if (cache != NULL) {
+			pthread_mutex_init(&cache->lock, NULL);
+			cache->threads	= threads;
+			cache->next = threads->caches;
+			// Published for locked_owner(), which walks the list unlocked
+			__atomic_store_n(&threads->caches, cache, __ATOMIC_RELEASE);
+		}
+	}
+	if (cache != NULL) {
+		cache->attached = true;
+	}
+	pthread_mutex_unlock(&threads->lock);
+
+	if (cache == NULL || pthread_setspecific(threads->key, cache) != 0) {
+		fprintf(stderr, "Error: Unable to allocate memory for block tracking.\n");
+		if (cache != NULL) {
+			cache_detach(cache);
+		}
+		return NULL;
+	}
+	return cache;
+}
+
+/**
+ * @brief Cache tracking ptr, returned locked, or NULL if none does.
+ *
+ * The calling thread's cache is tried first, so only blocks freed away
+ * from the thread that allocated them pay for a search. That search holds
+ * one cache lock at a time and not the registry lock: caches are only
+ * ever pushed at the head of the list until the context is destroyed, so
+ * a snapshot of the head reaches every cache that could own ptr.
+ */
+static GarbageCache *locked_owner(GarbageContext *ctx, void *ptr) {
+	if (ctx->threads->mode == GC_MODE_EMBEDDED) {
+		GarbageCache *cache = (GarbageCache *)embedded_header(ptr)->owner;
+		pthread_mutex_lock(&cache->lock);
+		return cache;
+	}
+
+	GarbageCache *own = own_cache(ctx);
+	if (own != NULL) {
+		pthread_mutex_lock(&own->lock);
+		if (garbage_find_block(&own->context, ptr) != NULL) {
+			return own;
+		}
+		pthread_mutex_unlock(&own->lock);
+	}
+
+	GarbageCache *found = NULL;
+	GarbageCache *head	= __atomic_load_n(&ctx->threads->caches, __ATOMIC_ACQUIRE);
+	for (GarbageCache *cache = head; cache != NULL && found == NULL; cache = cache->next) {
+		if (cache == own) {
+			continue;
+		}
+		pthread_mutex_lock(&cache->lock);
+		if (garbage_find_block(&cache->context, ptr) != NULL) {
+			found = cache;
+		} else {
+			pthread_mutex_unlock(&cache->lock);
+		}
+	}
+	return found;
+}
+
+static void *shared_alloc(GarbageContext *ctx, size_t nmemb, size_t size, bool zero) {
+	GarbageCache *cache = own_cache(ctx);
+	void *ptr;
+
+	if (cache == NULL) {
+		return NULL;
+	}
+	pthread_mutex_lock(&cache->lock);
+	ptr = zero ? gc_calloc(&cache->context, nmemb, size) : gc_malloc(&cache->context, size);
+	pthread_mutex_unlock(&cache->lock);
+	return ptr;
+}
+
+bool garbage_profile_enable(GarbageContext *ctx) {
+	if (ctx->mode == GC_MODE_ARENA) {
+		fprintf(stderr, "Error: Arena contexts cannot be profiled.\n");
+		return false;
+	}
+	if (ctx->profile != NULL) {
+		return true;
+	}
 
-/**
- * @brief Internal structure for allocation tracking.
- */
-typedef struct GarbageManager {
-	GarbageContext context; /**< Garbage manager context */
-	bool verbose_mode;		/**< Verbose mode enabled/disabled */
-} GarbageManager;
+	GarbageProfile *profile = calloc(1, sizeof(GarbageProfile));
+	if (profile == NULL) {
+		return false;
+	}
+	pthread_mutex_init(&profile->rate_lock, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &profile->start);
 
-static GarbageManager manager = {0};
+	if (ctx->threads != NULL) {
+		// Counter sets are only read once profile is set, under the cache lock
+		bool ok = true;
+		pthread_mutex_lock(&ctx->threads->lock);
+		for (GarbageCache *cache = ctx->threads->caches; cache != NULL && ok; cache = cache->next) {
+			cache->context.counters = calloc(1, sizeof(GarbageCounterSet));
+			ok						= cache->context.counters != NULL;
+		}
+		for (GarbageCache *cache = ctx->threads->caches; cache != NULL; cache = cache->next) {
+			pthread_mutex_lock(&cache->lock);
+			if (ok) {
+				cache->context.profile = profile;
+			} else {
+				free(cache->context.counters);
+				cache->context.counters = NULL;
+			}
+			pthread_mutex_unlock(&cache->lock);
+		}
+		if (ok) {
+			ctx->counters = &profile->counters;
+			ctx->profile  = profile;
+		}
+		pthread_mutex_unlock(&ctx->threads->lock);
+		if (!ok) {
+			profile_destroy(profile);
+			return false;
+		}
+	} else {
+		ctx->counters = &profile->counters;
+		ctx->profile  = profile;
+	}
+	return true;
+}
 
-/**
- * @brief Initializes a new context for allocation tracking.
- *
- * This function is called by garbage_init().
- */
-static void initialize_context(GarbageContext *ctx) {
-	ctx->total_allocations		= 0;
-	ctx->total_frees			= 0;
-	ctx->current_allocated_size = 0;
-	ctx->head					= NULL;
-	ctx->tail					= NULL;
+const char *garbage_profile_tag(const char *tag) {
+	const char *previous = profile_tag;
+
+	profile_tag = tag;
+	return previous;
+}
+
+static void dump_counters(FILE *out, const GarbageCounters *counters) {
+	fprintf(out, " %zu %zu %zu %zu\n", counters->allocations, counters->frees, counters->bytes, counters->live_bytes);
+}
+
+static void add_counters(GarbageCounters *sum, const GarbageCounters *counters) {
+	sum->allocations += counters->allocations;
+	sum->frees += counters->frees;
+	sum->bytes += counters->bytes;
+	sum->live_bytes += counters->live_bytes;
 }
 
 /**
- * @brief Prints a message if verbose mode is enabled.
+ * @brief Counters of a profiled context; for a shared context, the sum of
+ * its caches (to be freed by the caller), whose peak is the sum of theirs.
  */
-static void verbose_printf(const char *format, ...) {
-	if (manager.verbose_mode) {
-		va_list args;
-		va_start(args, format);
-		vprintf(format, args);
-		va_end(args);
+static GarbageCounterSet *collect_counters(GarbageContext *ctx) {
+	if (ctx->threads == NULL) {
+		return ctx->counters;
+	}
+
+	GarbageCounterSet *sum = calloc(1, sizeof(GarbageCounterSet));
+	if (sum == NULL) {
+		return NULL;
+	}
+	pthread_mutex_lock(&ctx->threads->lock);
+	for (GarbageCache *cache = ctx->threads->caches; cache != NULL; cache = cache->next) {
+		pthread_mutex_lock(&cache->lock);
+		const GarbageCounterSet *set = cache->context.counters;
+		add_counters(&sum->total, &set->total);
+		sum->peak_bytes += set->peak_bytes;
+		for (size_t i = 0; i < GC_PROFILE_SIZE_CLASSES; i++) {
+			add_counters(&sum->classes[i], &set->classes[i]);
+		}
+		for (size_t i = 0; i <= GC_PROFILE_MAX_SITES; i++) {
+			add_counters(&sum->sites[i], &set->sites[i]);
+		}
+		pthread_mutex_unlock(&cache->lock);
+	}
+	pthread_mutex_unlock(&ctx->threads->lock);
+	return sum;
+}
+
+bool garbage_profile_dump(GarbageContext *ctx, FILE *out) {
+	GarbageProfile *profile = ctx->profile;
+
+	if (profile == NULL) {
+		return false;
+	}
+	GarbageCounterSet *set = collect_counters(ctx);
+	if (set == NULL) {
+		return false;
+	}
+
+	fprintf(out, "gcprof 1\n");
+	fprintf(out, "total %zu %zu %zu %zu %zu\n", set->total.allocations, set->total.frees, set->total.bytes,
+			set->total.live_bytes, set->peak_bytes);
+
+	for (size_t i = 0; i < GC_PROFILE_SIZE_CLASSES; i++) {
+		if (set->classes[i].allocations == 0) {
+			continue;
+		}
+		if (i == GC_PROFILE_SIZE_CLASSES - 1) {
+			fprintf(out, "class inf");
+		} else {
+			fprintf(out, "class %zu", ((size_t)1 << i) - 1);
+		}
+		dump_counters(out, &set->classes[i]);
+	}
+
+	for (size_t i = 0; i < GC_PROFILE_MAX_SITES; i++) {
+		const GarbageSite *site = &profile->sites[i];
+		const void *key			= __atomic_load_n(&site->key, __ATOMIC_ACQUIRE);
+
+		if (key == NULL || set->sites[i].allocations == 0) {
+			continue;
+		}
+		if (__atomic_load_n(&site->tagged, __ATOMIC_RELAXED)) {
+			fprintf(out, "tag %s", (const char *)key);
+		} else {
+			fprintf(out, "site %p", key);
+		}
+		dump_counters(out, &set->sites[i]);
+	}
+	if (set->sites[GC_PROFILE_MAX_SITES].allocations != 0) {
+		fprintf(out, "other");
+		dump_counters(out, &set->sites[GC_PROFILE_MAX_SITES]);
 	}
+	if (set != ctx->counters) {
+		free(set);
+	}
+
+	pthread_mutex_lock(&profile->rate_lock);
+	size_t count = profile->rate_count;
+	size_t first = (count > GC_PROFILE_RATE_SAMPLES) ? count - GC_PROFILE_RATE_SAMPLES : 0;
+	for (size_t i = first; i < count; i++) {
+		const GarbageRateSample *sample = &profile->rate[i % GC_PROFILE_RATE_SAMPLES];
+		fprintf(out, "rate %llu %zu %zu\n", (unsigned long long)sample->elapsed_ns, sample->allocations, sample->bytes);
+	}
+	pthread_mutex_unlock(&profile->rate_lock);
+	return true;
 }
 
 GarbageContext *garbage_init(bool verbose_mode) {
+	return garbage_init_mode(verbose_mode, GC_MODE_INDEXED);
+}
+
+/**
+ * @brief Sets up the static context. The sampler is seeded here only, once.
+ */
+static GarbageContext *init_manager(bool verbose_mode, GarbageMode mode, size_t sample_period) {
 	initialize_context(&manager.context);
-	manager.verbose_mode = verbose_mode;
+	manager.context.mode		 = mode;
+	manager.context.chunk_size	 = GC_ARENA_CHUNK_SIZE;
+	manager.context.threads		 = NULL;
+	manager.context.verbose_mode = verbose_mode;
+	sampler_init(&manager.context, sample_period);
 
-	verbose_printf("Initializing garbage manager...\n");
+	verbose_printf(&manager.context, "Initializing garbage manager...\n");
 	return &manager.context;
 }
 
+GarbageContext *garbage_init_mode(bool verbose_mode, GarbageMode mode) {
+	return init_manager(verbose_mode, mode, (mode == GC_MODE_SAMPLED) ? GC_SAMPLE_PERIOD : 0);
+}
+
+GarbageContext *garbage_init_sampled(bool verbose_mode, size_t period) {
+	return init_manager(verbose_mode, GC_MODE_SAMPLED, period ? period : GC_SAMPLE_PERIOD);
+}
+
+void garbage_sample_seed(GarbageContext *ctx, uint64_t seed) {
+	if (ctx->mode == GC_MODE_SAMPLED) {
+		sampler_seed(ctx, seed);
+	}
+}
+
+GarbageContext *garbage_arena_create(size_t chunk_size) {
+	GarbageContext *ctx = malloc(sizeof(GarbageContext));
+
+	if (ctx == NULL) {
+		return NULL;
+	}
+
+	initialize_context(ctx);
+	ctx->mode		  = GC_MODE_ARENA;
+	ctx->chunk_size	  = chunk_size ? chunk_size : GC_ARENA_CHUNK_SIZE;
+	ctx->threads	  = NULL;
+	ctx->verbose_mode = false;
+	sampler_init(ctx, 0);
+	return ctx;
+}
+
+GarbageContext *garbage_shared_create(bool verbose_mode, GarbageMode mode) {
+	if (mode == GC_MODE_ARENA || mode == GC_MODE_SAMPLED) {
+		fprintf(stderr, "Error: Arena and sampled contexts cannot be shared between threads.\n");
+		return NULL;
+	}
+
+	GarbageContext *ctx		= malloc(sizeof(GarbageContext));
+	GarbageThreads *threads = malloc(sizeof(GarbageThreads));
+
+	if (ctx == NULL || threads == NULL || pthread_key_create(&threads->key, cache_detach) != 0) {
+		free(ctx);
+		free(threads);
+		return NULL;
+	}
+
+	pthread_mutex_init(&threads->lock, NULL);
+	threads->caches		  = NULL;
+	threads->mode		  = mode;
+	threads->verbose_mode = verbose_mode;
+	initialize_context(ctx);
+	ctx->mode		  = mode;
+	ctx->chunk_size	  = GC_ARENA_CHUNK_SIZE;
+	ctx->threads	  = threads;
+	ctx->verbose_mode = verbose_mode;
+	sampler_init(ctx, 0);
+
+	verbose_printf(ctx, "Initializing shared garbage manager...\n");
+	return ctx;
+}
+
+void garbage_shared_destroy(GarbageContext *ctx) {
+	if (ctx == NULL) {
+		return;
+	}
+
+	GarbageThreads *threads = ctx->threads;
+	garbage_cleanup(ctx);
+	pthread_key_delete(threads->key);
+	while (threads->caches != NULL) {
+		GarbageCache *next = threads->caches->next;
+		pthread_mutex_destroy(&threads->caches->lock);
+		free(threads->caches);
+		threads->caches = next;
+	}
+	pthread_mutex_destroy(&threads->lock);
+	free(threads);
+	free(ctx);
+}
+
+void garbage_merge_stats(GarbageContext *ctx) {
+	if (ctx->threads == NULL) {
+		return;
+	}
+
+	size_t allocations = 0, frees = 0, allocated_size = 0;
+	pthread_mutex_lock(&ctx->threads->lock);
+	for (GarbageCache *cache = ctx->threads->caches; cache != NULL; cache = cache->next) {
+		pthread_mutex_lock(&cache->lock);
+		allocations += cache->context.total_allocations;
+		frees += cache->context.total_frees;
+		allocated_size += cache->context.current_allocated_size;
+		pthread_mutex_unlock(&cache->lock);
+	}
+	pthread_mutex_unlock(&ctx->threads->lock);
+
+	ctx->total_allocations		= allocations;
+	ctx->total_frees			= frees;
+	ctx->current_allocated_size = allocated_size;
+}
+
+void garbage_arena_destroy(GarbageContext *ctx) {
+	if (ctx == NULL) {
+		return;
+	}
+	arena_release(ctx);
+	free(ctx);
+}
+
+GarbageMark garbage_mark(GarbageContext *ctx) {
+	GarbageMark mark = {0};
+
+	if (ctx->mode != GC_MODE_ARENA) {
+		fprintf(stderr, "Error: Marks need an arena context.\n");
+		return mark;
+	}
+
+	mark.chunk			= ctx->chunks;
+	mark.used			= ctx->chunks ? ctx->chunks->used : 0;
+	mark.live			= ctx->total_allocations - ctx->total_frees;
+	mark.allocated_size = ctx->current_allocated_size;
+	return mark;
+}
+
+void garbage_rewind(GarbageContext *ctx, GarbageMark mark) {
+	size_t live = ctx->total_allocations - ctx->total_frees;
+
+	if (ctx->mode != GC_MODE_ARENA) {
+		fprintf(stderr, "Error: Marks need an arena context.\n");
+		return;
+	}
+
+	while (ctx->chunks != NULL && ctx->chunks != mark.chunk) {
+		arena_pop_chunk(ctx);
+	}
+	if (ctx->chunks != NULL) {
+		ctx->chunks->used = mark.used;
+	}
+
+	if (live > mark.live) {
+		ctx->total_frees += live - mark.live;
+	}
+	ctx->current_allocated_size = mark.allocated_size;
+	verbose_printf(ctx, "Arena rewound: %zu allocations released\n", (live > mark.live) ? live - mark.live : 0);
+}
+
 void garbage_cleanup(GarbageContext *ctx) {
 	MemoryBlock *current = ctx->head;
 	MemoryBlock *next;
 
+	if (ctx->threads != NULL) {
+		pthread_mutex_lock(&ctx->threads->lock);
+		for (GarbageCache *cache = ctx->threads->caches; cache != NULL; cache = cache->next) {
+			pthread_mutex_lock(&cache->lock);
+			cache->context.profile = NULL; // Borrowed from ctx
+			free(cache->context.counters);
+			garbage_cleanup(&cache->context);
+			pthread_mutex_unlock(&cache->lock);
+		}
+		pthread_mutex_unlock(&ctx->threads->lock);
+		profile_destroy(ctx->profile);
+		initialize_context(ctx);
+		return;
+	}
+
 	while (current != NULL) {
 		next = current->next;
-		free(current->ptr); // Free the actual allocated memory first
-		free(current);		// Then free the block structure
+		if (uses_index(ctx)) {
+			free(current->ptr); // Free the actual allocated memory first
+		}
+		free(current); // Then free the block structure (or header and data)
 		current = next;
 	}
 
+	free(ctx->index);
+	arena_release(ctx);
+	profile_destroy(ctx->profile);
 	initialize_context(ctx);
-	verbose_printf("Garbage manager cleanup completed.\n");
+	verbose_printf(ctx, "Garbage manager cleanup completed.\n");
 }
 
 void garbage_add_block(GarbageContext *ctx, void *ptr, size_t size) {
+	if (ctx->profile != NULL && alloc_site == NULL) {
+		profile_enter(__builtin_return_address(0));
+		garbage_add_block(ctx, ptr, size);
+		alloc_site = NULL;
+		return;
+	}
+	if (ctx->threads != NULL && ctx->mode == GC_MODE_INDEXED) {
+		GarbageCache *cache = own_cache(ctx);
+		if (cache != NULL) {
+			pthread_mutex_lock(&cache->lock);
+			garbage_add_block(&cache->context, ptr, size);
+			pthread_mutex_unlock(&cache->lock);
+		}
+		return;
+	}
+	if (!uses_index(ctx)) {
+		fprintf(stderr, "Error: Embedded and arena modes only track gc_* allocations.\n");
+		return;
+	}
+	if (ctx->mode == GC_MODE_SAMPLED && !sampler_hit(ctx, size)) {
+		return;
+	}
+	if ((ctx->index_count + 1) * 4 > ctx->index_capacity * 3 && !index_grow(ctx)) {
+		fprintf(stderr, "Error: Unable to allocate memory for block tracking.\n");
+		return;
+	}
+
 	MemoryBlock *new_block = (MemoryBlock *)malloc(sizeof(MemoryBlock));
 
 	if (new_block == NULL) {
@@ -84,126 +1241,233 @@ void garbage_add_block(GarbageContext *ctx, void *ptr, size_t size) {
 		return;
 	}
 
+	// A pointer tracked twice keeps only its latest record
+	size_t slot = index_slot(ctx, ptr);
+	if (ctx->index[slot] != NULL) {
+		detach_block(ctx, ctx->index[slot], slot);
+		slot = index_slot(ctx, ptr);
+	}
+	ctx->index[slot] = new_block;
+	ctx->index_count++;
+
 	new_block->ptr			   = ptr;
 	new_block->size			   = size;
 	new_block->allocation_time = time(NULL);
-	new_block->prev			   = ctx->tail;
-	new_block->next			   = NULL;
+	link_block(ctx, new_block);
+}
 
-	if (ctx->head == NULL) {
-		ctx->head = new_block;
-	} else {
-		ctx->tail->next = new_block;
-	}
+/**
+ * @brief Stops tracking the block indexed at slot, counting it as freed.
+ */
+static void release_slot(GarbageContext *ctx, size_t slot) {
+	verbose_printf(ctx, "Block freed:\n");
+	verbose_printf(ctx, "- Pointer: %p\n", ctx->index[slot]->ptr);
 
-	ctx->tail = new_block;
-	ctx->current_allocated_size += size;
-	ctx->total_allocations++;
+	detach_block(ctx, ctx->index[slot], slot);
+	ctx->total_frees++;
+}
 
-	verbose_printf("New allocation:\n");
-	verbose_printf("- Pointer: %p\n", ptr);
-	verbose_printf("- Size: %zu bytes\n", size);
+/**
+ * @brief Stops tracking ptr; returns false (and reports it) if untracked,
+ * unless the sampler may simply have skipped it.
+ */
+static bool untrack_block(GarbageContext *ctx, void *ptr) {
+	if (garbage_find_block(ctx, ptr) == NULL) {
+		if (ctx->mode == GC_MODE_SAMPLED) {
+			return true;
+		}
+		fprintf(stderr, "Error: Block not found in list.\n");
+		return false;
+	}
+	release_slot(ctx, index_slot(ctx, ptr));
+	return true;
 }
 
 void garbage_remove_block(GarbageContext *ctx, void *ptr) {
-	MemoryBlock *block = garbage_find_block(ctx, ptr);
-
-	if (block == NULL) {
-		fprintf(stderr, "Error: Block not found in list.\n");
+	if (!uses_index(ctx)) {
+		fprintf(stderr, "Error: Embedded and arena modes only track gc_* allocations.\n");
 		return;
 	}
-
-	// Print debug info before freeing
-	verbose_printf("Block freed:\n");
-	verbose_printf("- Pointer: %p\n", ptr);
-
-	// Detach block from linked list
-	if (block->prev != NULL) {
-		block->prev->next = block->next;
-	} else {
-		ctx->head = block->next;
+	if (ctx->threads != NULL) {
+		GarbageCache *cache = locked_owner(ctx, ptr);
+		if (cache == NULL) {
+			fprintf(stderr, "Error: Block not found in list.\n");
+			return;
+		}
+		untrack_block(&cache->context, ptr);
+		pthread_mutex_unlock(&cache->lock);
+		return;
 	}
+	untrack_block(ctx, ptr);
+}
 
-	if (block->next != NULL) {
-		block->next->prev = block->prev;
-	} else {
-		ctx->tail = block->prev;
+MemoryBlock *garbage_find_block(GarbageContext *ctx, void *ptr) {
+	if (ctx->threads != NULL) {
+		MemoryBlock *block = NULL;
+		pthread_mutex_lock(&ctx->threads->lock);
+		for (GarbageCache *cache = ctx->threads->caches; cache != NULL && block == NULL; cache = cache->next) {
+			pthread_mutex_lock(&cache->lock);
+			block = garbage_find_block(&cache->context, ptr);
+			pthread_mutex_unlock(&cache->lock);
+		}
+		pthread_mutex_unlock(&ctx->threads->lock);
+		return block;
 	}
+	if (!uses_index(ctx)) {
+		// No index: walk the list, which also tells freed pointers apart
+		for (MemoryBlock *current = ctx->head; current != NULL; current = current->next) {
+			if (current->ptr == ptr) {
+				return current;
+			}
+		}
+		return NULL;
+	}
+	if (ctx->index_count == 0) {
+		return NULL;
+	}
+	return ctx->index[index_slot(ctx, ptr)];
+}
 
-	ctx->current_allocated_size -= block->size;
-	ctx->total_frees++;
-
-	// Store pointer value before freeing
-	void *freed_ptr = block->ptr;
-
-	// Mark as freed before freeing the block structure
-	block->ptr = NULL;
-
-	// Free the block structure
-	free(block);
+/**
+ * @brief Prints the blocks of a context; false if it has none.
+ */
+static bool report_blocks(const GarbageContext *ctx, bool first) {
+	if (ctx->head == NULL) {
+		return false;
+	}
+	if (first) {
+		printf("\nList of allocated blocks:\n");
+	}
 
-	// Update other blocks to prevent double-free
-	MemoryBlock *current = ctx->head;
-	while (current != NULL) {
-		if (current->ptr == freed_ptr) {
-			current->ptr = NULL; // Mark any other references as freed
+	for (const MemoryBlock *current = ctx->head; current != NULL; current = current->next) {
+		printf("- Pointer: %p\n", current->ptr);
+		printf("- Size: %zu bytes\n", current->size);
+		if (current->allocation_time != 0) {
+			printf("- Allocation time: %s", ctime(&current->allocation_time));
+		} else {
+			printf("- Allocation time: not recorded\n");
+		}
+		if (ctx->mode == GC_MODE_SAMPLED) {
+			printf("- Estimated blocks: %.1f\n", sampler_weight(ctx, current->size));
 		}
-		current = current->next;
 	}
+	return true;
 }
 
-MemoryBlock *garbage_find_block(GarbageContext *ctx, void *ptr) {
-	MemoryBlock *current = ctx->head;
+void garbage_estimate_live(GarbageContext *ctx, size_t *blocks, size_t *bytes) {
+	double live_blocks = 0, live_bytes = 0;
 
-	while (current != NULL) {
-		if (current->ptr == ptr) {
-			return current;
+	if (ctx->mode == GC_MODE_SAMPLED) {
+		for (const MemoryBlock *current = ctx->head; current != NULL; current = current->next) {
+			double weight = sampler_weight(ctx, current->size);
+			live_blocks += weight;
+			live_bytes += weight * (double)current->size;
 		}
-		current = current->next;
+	} else {
+		garbage_merge_stats(ctx);
+		live_blocks = (double)(ctx->total_allocations - ctx->total_frees);
+		live_bytes	= (double)ctx->current_allocated_size;
 	}
 
-	return NULL;
+	if (blocks != NULL) {
+		*blocks = (size_t)(live_blocks + 0.5);
+	}
+	if (bytes != NULL) {
+		*bytes = (size_t)(live_bytes + 0.5);
+	}
 }
 
 void garbage_report_usage(GarbageContext *ctx) {
+	garbage_merge_stats(ctx);
 	printf("Memory Report:\n");
 	printf("- Total allocations: %zu\n", ctx->total_allocations);
 	printf("- Total frees: %zu\n", ctx->total_frees);
 	printf("- Current total allocated size: %zu bytes\n", ctx->current_allocated_size);
 
-	if (ctx->head == NULL) {
-		printf("No current allocations.\n");
-		return;
+	if (ctx->mode == GC_MODE_SAMPLED) {
+		size_t blocks, bytes;
+		garbage_estimate_live(ctx, &blocks, &bytes);
+		printf("- Sample period: %zu bytes (counts above are sampled blocks only)\n", ctx->sample_period);
+		printf("- Estimated live: %zu blocks, %zu bytes\n", blocks, bytes);
 	}
 
-	printf("\nList of allocated blocks:\n");
-	MemoryBlock *current = ctx->head;
+	if (ctx->mode == GC_MODE_ARENA) {
+		size_t count = 0, reserved = 0;
+		for (GarbageChunk *chunk = ctx->chunks; chunk != NULL; chunk = chunk->prev) {
+			count++;
+			reserved += chunk->size;
+		}
+		printf("- Arena chunks: %zu (%zu bytes reserved)\n", count, reserved);
+		return;
+	}
 
-	while (current != NULL) {
-		printf("- Pointer: %p\n", current->ptr);
-		printf("- Size: %zu bytes\n", current->size);
-		printf("- Allocation time: %s", ctime(&current->allocation_time));
+	bool listed = false;
+	if (ctx->threads != NULL) {
+		pthread_mutex_lock(&ctx->threads->lock);
+		for (GarbageCache *cache = ctx->threads->caches; cache != NULL; cache = cache->next) {
+			pthread_mutex_lock(&cache->lock);
+			listed |= report_blocks(&cache->context, !listed);
+			pthread_mutex_unlock(&cache->lock);
+		}
+		pthread_mutex_unlock(&ctx->threads->lock);
+	} else {
+		listed = report_blocks(ctx, true);
+	}
 
-		current = current->next;
+	if (!listed) {
+		printf("No current allocations.\n");
 	}
 }
 
 void garbage_free_oldest_block(GarbageContext *ctx) {
+	if (ctx->threads != NULL) {
+		GarbageCache *cache = own_cache(ctx);
+		if (cache != NULL) {
+			pthread_mutex_lock(&cache->lock);
+			garbage_free_oldest_block(&cache->context);
+			pthread_mutex_unlock(&cache->lock);
+		}
+		return;
+	}
 	if (ctx->head == NULL) {
-		verbose_printf("No blocks to free.\n");
+		verbose_printf(ctx, "No blocks to free.\n");
 		return;
 	}
 
 	MemoryBlock *oldest = ctx->head;
 	void *ptr			= oldest->ptr;
 
-	verbose_printf("Freeing oldest block:\n");
-	verbose_printf("- Pointer: %p\n", ptr);
+	verbose_printf(ctx, "Freeing oldest block:\n");
+	verbose_printf(ctx, "- Pointer: %p\n", ptr);
 
-	garbage_remove_block(ctx, ptr); // This will free both the memory and the block
+	gc_free(ctx, ptr);
 }
 
 void *gc_malloc(GarbageContext *ctx, size_t size) {
+	if (ctx->mode == GC_MODE_SAMPLED && size < ctx->bytes_until_sample) {
+		// Skipped by the sampler: nothing to record
+		void *ptr = malloc(size);
+		if (ptr != NULL) {
+			ctx->bytes_until_sample -= size;
+		}
+		return ptr;
+	}
+	if (ctx->profile != NULL && alloc_site == NULL) {
+		profile_enter(__builtin_return_address(0));
+		void *ptr  = gc_malloc(ctx, size);
+		alloc_site = NULL;
+		return ptr;
+	}
+	if (ctx->threads != NULL) {
+		return shared_alloc(ctx, 1, size, false);
+	}
+	if (ctx->mode == GC_MODE_EMBEDDED) {
+		return embedded_alloc(ctx, size, false);
+	}
+	if (ctx->mode == GC_MODE_ARENA) {
+		return arena_alloc(ctx, size, false);
+	}
+
 	void *ptr = malloc(size);
 	if (ptr != NULL) {
 		garbage_add_block(ctx, ptr, size);
@@ -212,6 +1476,25 @@ void *gc_malloc(GarbageContext *ctx, size_t size) {
 }
 
 void *gc_calloc(GarbageContext *ctx, size_t nmemb, size_t size) {
+	if (ctx->profile != NULL && alloc_site == NULL) {
+		profile_enter(__builtin_return_address(0));
+		void *ptr  = gc_calloc(ctx, nmemb, size);
+		alloc_site = NULL;
+		return ptr;
+	}
+	if (ctx->threads != NULL) {
+		return shared_alloc(ctx, nmemb, size, true);
+	}
+	if (!uses_index(ctx)) {
+		if (size != 0 && nmemb > SIZE_MAX / size) {
+			return NULL;
+		}
+		if (ctx->mode == GC_MODE_ARENA) {
+			return arena_alloc(ctx, nmemb * size, true);
+		}
+		return embedded_alloc(ctx, nmemb * size, true);
+	}
+
 	void *ptr = calloc(nmemb, size);
 	if (ptr != NULL) {
 		garbage_add_block(ctx, ptr, nmemb * size);
@@ -220,25 +1503,45 @@ void *gc_calloc(GarbageContext *ctx, size_t nmemb, size_t size) {
 }
 
 void *gc_realloc(GarbageContext *ctx, void *ptr, size_t size) {
+	if (ctx->profile != NULL && alloc_site == NULL) {
+		profile_enter(__builtin_return_address(0));
+		void *new_ptr = gc_realloc(ctx, ptr, size);
+		alloc_site	  = NULL;
+		return new_ptr;
+	}
 	if (ptr == NULL) {
 		return gc_malloc(ctx, size);
 	}
-
-	MemoryBlock *block = garbage_find_block(ctx, ptr);
-	if (block == NULL) {
-		void *new_ptr = realloc(ptr, size);
-		if (new_ptr != NULL) {
-			garbage_add_block(ctx, new_ptr, size);
+	if (ctx->threads != NULL) {
+		GarbageCache *cache = locked_owner(ctx, ptr);
+		if (cache == NULL) {
+			fprintf(stderr, "Error: Block not found in list.\n");
+			return NULL;
 		}
+		void *new_ptr = gc_realloc(&cache->context, ptr, size);
+		pthread_mutex_unlock(&cache->lock);
 		return new_ptr;
 	}
+	if (ctx->mode == GC_MODE_EMBEDDED) {
+		return embedded_realloc(ctx, ptr, size);
+	}
+	if (ctx->mode == GC_MODE_ARENA) {
+		return arena_realloc(ctx, ptr, size);
+	}
 
-	// Remove the old block before reallocating
-	garbage_remove_block(ctx, ptr);
-
+	// Looked up first: ptr must not be used once realloc has run
+	bool tracked  = garbage_find_block(ctx, ptr) != NULL;
+	size_t slot	  = tracked ? index_slot(ctx, ptr) : 0;
 	void *new_ptr = realloc(ptr, size);
+
+	// On failure ptr is untouched and stays tracked, unless size was 0
+	if (new_ptr == NULL && size != 0) {
+		return NULL;
+	}
+	if (tracked) {
+		release_slot(ctx, slot);
+	}
 	if (new_ptr != NULL) {
-		// Add the new block after reallocation
 		garbage_add_block(ctx, new_ptr, size);
 	}
 
@@ -246,6 +1549,12 @@ void *gc_realloc(GarbageContext *ctx, void *ptr, size_t size) {
 }
 
 void *gc_strdup(GarbageContext *ctx, const char *str) {
+	if (ctx->profile != NULL && alloc_site == NULL) {
+		profile_enter(__builtin_return_address(0));
+		void *ptr  = gc_strdup(ctx, str);
+		alloc_site = NULL;
+		return ptr;
+	}
 	size_t len = strlen(str) + 1;
 	void *ptr  = gc_malloc(ctx, len);
 	if (ptr != NULL) {
@@ -256,5 +1565,36 @@ void *gc_strdup(GarbageContext *ctx, const char *str) {
 
 void gc_free(GarbageContext *ctx, void *ptr) {
 	if (ptr == NULL) return;
-	garbage_remove_block(ctx, ptr);
+	if (ctx->mode == GC_MODE_SAMPLED) {
+		// Most blocks were never recorded: one probe, no error if absent
+		if (ctx->index_count != 0) {
+			size_t slot = index_slot(ctx, ptr);
+			if (ctx->index[slot] != NULL) {
+				release_slot(ctx, slot);
+			}
+		}
+		free(ptr);
+		return;
+	}
+	if (ctx->threads != NULL) {
+		GarbageCache *cache = locked_owner(ctx, ptr);
+		if (cache == NULL) {
+			fprintf(stderr, "Error: Block not found in list.\n");
+			return;
+		}
+		gc_free(&cache->context, ptr);
+		pthread_mutex_unlock(&cache->lock);
+		return;
+	}
+	if (ctx->mode == GC_MODE_EMBEDDED) {
+		embedded_free(ctx, ptr);
+		return;
+	}
+	if (ctx->mode == GC_MODE_ARENA) {
+		return; // Released by garbage_rewind or garbage_cleanup
+	}
+	// Untracked pointers are reported and left alone (double free guard)
+	if (untrack_block(ctx, ptr)) {
+		free(ptr);
+	}
 }
@@ -0,0 +1,277 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   pool.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <lib/pool.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Objects moved between a thread cache and the pool at once */
+#define POOL_CACHE_BATCH 32
+
+/**
+ * @brief Free object: its first word links the freelist.
+ */
+struct PoolObject {
+	PoolObject *next;
+};
+
+/**
+ * @brief Slab header; objects of a single class are carved from data.
+ */
+struct PoolSlab {
+	PoolSlab *next;		/**< Next slab of the pool */
+	max_align_t data[]; /**< POOL_SLAB_SIZE bytes of objects */
+};
+
+/**
+ * @brief Objects held by one thread, per class.
+ */
+struct PoolCache {
+	PoolObject *objects[POOL_CLASS_COUNT]; /**< Cached objects per class */
+	unsigned count[POOL_CLASS_COUNT];	   /**< Length of each list */
+	ObjectPool *pool;					   /**< Owning pool */
+	PoolCache *prev;					   /**< Registry links */
+	PoolCache *next;
+};
+
+static size_t size_class(size_t size) {
+	return size ? (size - 1) / POOL_ALIGN : 0;
+}
+
+/**
+ * @brief Takes an object of class c from its freelist or its slab.
+ *
+ * Slabs are carved lazily, so memory is only touched when handed out.
+ * The pool lock must be held in thread cache mode.
+ */
+static void *take_object(ObjectPool *pool, size_t c) {
+	PoolObject *object = pool->free_lists[c];
+	size_t object_size = (c + 1) * POOL_ALIGN;
+
+	if (object != NULL) {
+		pool->free_lists[c] = object->next;
+		return object;
+	}
+
+	if (pool->bump[c] == pool->bump_end[c]) {
+		PoolSlab *slab = malloc(sizeof(PoolSlab) + POOL_SLAB_SIZE);
+		if (slab == NULL) {
+			return NULL;
+		}
+		slab->next		  = pool->slabs;
+		pool->slabs		  = slab;
+		pool->bump[c]	  = (char *)slab->data;
+		pool->bump_end[c] = pool->bump[c] + POOL_SLAB_SIZE / object_size * object_size;
+	}
+
+	void *ptr = pool->bump[c];
+	pool->bump[c] += object_size;
+	return ptr;
+}
+
+static void put_object(ObjectPool *pool, void *ptr, size_t c) {
+	PoolObject *object	= ptr;
+	object->next		= pool->free_lists[c];
+	pool->free_lists[c] = object;
+}
+
+/**
+ * @brief Thread exit: hands the cached objects back to the pool.
+ */
+static void cache_release(void *arg) {
+	PoolCache *cache = arg;
+	ObjectPool *pool = cache->pool;
+
+	pthread_mutex_lock(&pool->lock);
+	for (size_t c = 0; c < POOL_CLASS_COUNT; c++) {
+		while (cache->objects[c] != NULL) {
+			PoolObject *object = cache->objects[c];
+			cache->objects[c]  = object->next;
+			put_object(pool, object, c);
+		}
+	}
+	if (cache->prev != NULL) {
+		cache->prev->next = cache->next;
+	} else {
+		pool->caches = cache->next;
+	}
+	if (cache->next != NULL) {
+		cache->next->prev = cache->prev;
+	}
+	pthread_mutex_unlock(&pool->lock);
+	free(cache);
+}
+
+/**
+ * @brief The calling thread's cache, created on first use.
+ */
+static PoolCache *thread_cache(ObjectPool *pool) {
+	PoolCache *cache = pthread_getspecific(pool->cache_key);
+
+	if (cache != NULL) {
+		return cache;
+	}
+
+	cache = calloc(1, sizeof(PoolCache));
+	if (cache == NULL) {
+		return NULL;
+	}
+	cache->pool = pool;
+	if (pthread_setspecific(pool->cache_key, cache) != 0) {
+		free(cache);
+		return NULL;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	cache->next = pool->caches;
+	if (pool->caches != NULL) {
+		pool->caches->prev = cache;
+	}
+	pool->caches = cache;
+	pthread_mutex_unlock(&pool->lock);
+	return cache;
+}
+
+bool pool_init(ObjectPool *pool, bool thread_cache) {
+	memset(pool, 0, sizeof(*pool));
+	pool->thread_cache = thread_cache;
+
+	if (!thread_cache) {
+		return true;
+	}
+	if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+		return false;
+	}
+	if (pthread_key_create(&pool->cache_key, cache_release) != 0) {
+		pthread_mutex_destroy(&pool->lock);
+		return false;
+	}
+	return true;
+}
+
+void pool_destroy(ObjectPool *pool) {
+	if (pool->thread_cache) {
+		// Deleting the key first keeps exiting threads out of the pool
+		pthread_key_delete(pool->cache_key);
+		while (pool->caches != NULL) {
+			PoolCache *next = pool->caches->next;
+			free(pool->caches);
+			pool->caches = next;
+		}
+		pthread_mutex_destroy(&pool->lock);
+	}
+
+	while (pool->slabs != NULL) {
+		PoolSlab *next = pool->slabs->next;
+		free(pool->slabs);
+		pool->slabs = next;
+	}
+	memset(pool, 0, sizeof(*pool));
+}
+
+void *pool_alloc(ObjectPool *pool, size_t size) {
+	if (size > POOL_MAX_SIZE) {
+		return malloc(size);
+	}
+
+	size_t c = size_class(size);
+	if (!pool->thread_cache) {
+		return take_object(pool, c);
+	}
+
+	PoolCache *cache = thread_cache(pool);
+	if (cache == NULL) {
+		pthread_mutex_lock(&pool->lock);
+		void *ptr = take_object(pool, c);
+		pthread_mutex_unlock(&pool->lock);
+		return ptr;
+	}
+
+	if (cache->objects[c] == NULL) {
+		// Refill a batch under one lock acquisition
+		pthread_mutex_lock(&pool->lock);
+		while (cache->count[c] < POOL_CACHE_BATCH) {
+			PoolObject *object = take_object(pool, c);
+			if (object == NULL) {
+				break;
+			}
+			object->next	  = cache->objects[c];
+			cache->objects[c] = object;
+			cache->count[c]++;
+		}
+		pthread_mutex_unlock(&pool->lock);
+		if (cache->objects[c] == NULL) {
+			return NULL;
+		}
+	}
+
+	PoolObject *object = cache->objects[c];
+	cache->objects[c]  = object->next;
+	cache->count[c]--;
+	return object;
+}
+
+void pool_free(ObjectPool *pool, void *ptr, size_t size) {
+	if (ptr == NULL) {
+		return;
+	}
+	if (size > POOL_MAX_SIZE) {
+		free(ptr);
+		return;
+	}
+
+	size_t c = size_class(size);
+	if (!pool->thread_cache) {
+		put_object(pool, ptr, c);
+		return;
+	}
+
+	PoolCache *cache = thread_cache(pool);
+	if (cache == NULL) {
+		pthread_mutex_lock(&pool->lock);
+		put_object(pool, ptr, c);
+		pthread_mutex_unlock(&pool->lock);
+		return;
+	}
+
+	PoolObject *object = ptr;
+	object->next	   = cache->objects[c];
+	cache->objects[c]  = object;
+	if (++cache->count[c] < 2 * POOL_CACHE_BATCH) {
+		return;
+	}
+
+	// Too many cached: give a batch back so other threads can use it
+	pthread_mutex_lock(&pool->lock);
+	while (cache->count[c] > POOL_CACHE_BATCH) {
+		object			  = cache->objects[c];
+		cache->objects[c] = object->next;
+		cache->count[c]--;
+		put_object(pool, object, c);
+	}
+	pthread_mutex_unlock(&pool->lock);
+}
+
+static void *pool_alloc_hook(void *ctx, size_t size) {
+	return pool_alloc(ctx, size);
+}
+
+static void pool_free_hook(void *ctx, void *ptr, size_t size) {
+	pool_free(ctx, ptr, size);
+}
+
+Allocator pool_allocator(ObjectPool *pool) {
+	Allocator allocator = {pool_alloc_hook, pool_free_hook, pool};
+	return allocator;
+}
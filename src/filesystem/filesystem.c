@@ -8,6 +8,8 @@
 /*                                                    ###   ########.fr       */
 /* ************************************************************************** */
 
+#define _GNU_SOURCE // madvise, MAP_POPULATE, copy_file_range
+
 #include <lib/filesystem/filesystem.h>
 
 #include <dirent.h>
@@ -19,6 +21,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+
+#define FS_COPY_CHUNK (1 << 30)       // Octets demandés au noyau par appel
+#define FS_COPY_BUFFER_SIZE (1 << 20) // Tampon de la copie en espace utilisateur
+#define FS_COPY_BUFFER_ALIGN 4096
 
 // --------------------------------------------------------------------------
 // Error Handling
@@ -152,52 +165,72 @@ int fs_close(t_file *file) {
 	return FS_SUCCESS;
 }
 
-int fs_read(t_file *file, void *buffer, uint32_t size) {
-	if (!file || !buffer || file->is_directory)
-		return FS_ERROR;
-
-	// Vérifier les droits d'accès à l'aide de fcntl()
+// Vérifier les droits d'accès à l'aide de fcntl()
+static int fs_check_access(t_file *file, int acc_wanted, int io_error) {
 	int flags = fcntl(file->fd, F_GETFL);
 	if (flags == -1)
-		return FS_ERROR_FILE_READ;
+		return io_error;
 	int acc_mode = flags & O_ACCMODE;
-	if (acc_mode != O_RDONLY && acc_mode != O_RDWR)
+	if (acc_mode != acc_wanted && acc_mode != O_RDWR)
 		return FS_PERMISSION_DENIED;
+	return FS_SUCCESS;
+}
+
+// offset < 0 : position courante du fichier (read), sinon pread
+static ssize_t fs_read_at(t_file *file, void *buffer, size_t size, off_t offset) {
+	if (!file || !buffer || file->is_directory)
+		return FS_ERROR;
+	int ret = fs_check_access(file, O_RDONLY, FS_ERROR_FILE_READ);
+	if (ret != FS_SUCCESS)
+		return ret;
+	if (size > SSIZE_MAX)
+		size = SSIZE_MAX;
 
-	ssize_t total_read = 0;
+	size_t total_read  = 0;
 	ssize_t bytes_read = 0;
 	while (total_read < size) {
-		bytes_read = read(file->fd, (char *)buffer + total_read, size - total_read);
-		if (bytes_read < 0)
+		if (offset < 0)
+			bytes_read = read(file->fd, (char *)buffer + total_read, size - total_read);
+		else
+			bytes_read = pread(file->fd, (char *)buffer + total_read, size - total_read, offset + total_read);
+		if (bytes_read < 0) {
+			if (errno == EINTR)
+				continue;
 			return FS_ERROR_FILE_READ;
-		else if (bytes_read == 0) // Fin de fichier
+		} else if (bytes_read == 0) // Fin de fichier
 			break;
 		total_read += bytes_read;
-		file->offset += bytes_read;
+		if (offset < 0)
+			file->offset += bytes_read;
 	}
 	return total_read;
 }
 
-int fs_write(t_file *file, const void *buffer, uint32_t size) {
+static ssize_t fs_write_at(t_file *file, const void *buffer, size_t size, off_t offset) {
 	if (!file || !buffer || file->is_directory)
 		return FS_ERROR;
+	int ret = fs_check_access(file, O_WRONLY, FS_ERROR_FILE_WRITE);
+	if (ret != FS_SUCCESS)
+		return ret;
+	if (size > SSIZE_MAX)
+		size = SSIZE_MAX;
 
-	// Vérifier les droits d'accès à l'aide de fcntl()
-	int flags = fcntl(file->fd, F_GETFL);
-	if (flags == -1)
-		return FS_ERROR_FILE_WRITE;
-	int acc_mode = flags & O_ACCMODE;
-	if (acc_mode != O_WRONLY && acc_mode != O_RDWR)
-		return FS_PERMISSION_DENIED;
-
-	ssize_t total_written = 0;
+	size_t total_written  = 0;
 	ssize_t bytes_written = 0;
 	while (total_written < size) {
-		bytes_written = write(file->fd, (const char *)buffer + total_written, size - total_written);
-		if (bytes_written < 0)
+		if (offset < 0)
+			bytes_written = write(file->fd, (const char *)buffer + total_written, size - total_written);
+		else
+			bytes_written =
+				pwrite(file->fd, (const char *)buffer + total_written, size - total_written, offset + total_written);
+		if (bytes_written < 0) {
+			if (errno == EINTR)
+				continue;
 			return FS_ERROR_FILE_WRITE;
+		}
 		total_written += bytes_written;
-		file->offset += bytes_written;
+		if (offset < 0)
+			file->offset += bytes_written;
 	}
 
 	// Mettre à jour la taille du fichier
@@ -209,6 +242,34 @@ int fs_write(t_file *file, const void *buffer, uint32_t size) {
 	return total_written;
 }
 
+int fs_read(t_file *file, void *buffer, uint32_t size) {
+	return fs_read_at(file, buffer, size, -1);
+}
+
+int fs_write(t_file *file, const void *buffer, uint32_t size) {
+	return fs_write_at(file, buffer, size, -1);
+}
+
+ssize_t fs_read64(t_file *file, void *buffer, size_t size) {
+	return fs_read_at(file, buffer, size, -1);
+}
+
+ssize_t fs_write64(t_file *file, const void *buffer, size_t size) {
+	return fs_write_at(file, buffer, size, -1);
+}
+
+ssize_t fs_pread(t_file *file, void *buffer, size_t size, off_t offset) {
+	if (offset < 0)
+		return FS_ERROR;
+	return fs_read_at(file, buffer, size, offset);
+}
+
+ssize_t fs_pwrite(t_file *file, const void *buffer, size_t size, off_t offset) {
+	if (offset < 0)
+		return FS_ERROR;
+	return fs_write_at(file, buffer, size, offset);
+}
+
 bool fs_exists(const char *path) {
 	return access(path, F_OK) == 0;
 }
@@ -230,6 +291,99 @@ int fs_delete(const char *path) {
 	return unlink(path) == 0 ? FS_SUCCESS : FS_ERROR;
 }
 
+// --------------------------------------------------------------------------
+// Memory-Mapped Files
+// --------------------------------------------------------------------------
+
+// Les conseils au noyau sont facultatifs : un refus n'empêche pas le mapping
+static void fs_map_advise(t_mapping *mapping) {
+	if (mapping->flags & FS_MAP_SEQUENTIAL)
+		madvise(mapping->data, mapping->length, MADV_SEQUENTIAL);
+	else if (mapping->flags & FS_MAP_RANDOM)
+		madvise(mapping->data, mapping->length, MADV_RANDOM);
+#ifdef MADV_HUGEPAGE
+	if (mapping->flags & FS_MAP_HUGE_PAGES)
+		madvise(mapping->data, mapping->length, MADV_HUGEPAGE);
+#endif
+#ifndef MAP_POPULATE
+	if (mapping->flags & FS_MAP_POPULATE)
+		madvise(mapping->data, mapping->length, MADV_WILLNEED);
+#endif
+}
+
+t_mapping *fs_map(const char *path, int flags) {
+	if (!path)
+		return NULL;
+
+	bool writable = flags & FS_MAP_WRITE;
+	int fd		  = open(path, writable ? O_RDWR : O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) < 0) {
+		close(fd);
+		return NULL;
+	}
+	// Seuls les fichiers réguliers ont une taille fixe à mapper
+	if (!S_ISREG(st.st_mode) || (uint64_t)st.st_size > SIZE_MAX) {
+		close(fd);
+		errno = S_ISREG(st.st_mode) ? EFBIG : EINVAL;
+		return NULL;
+	}
+
+	t_mapping *mapping = malloc(sizeof(t_mapping));
+	if (!mapping) {
+		close(fd);
+		return NULL;
+	}
+	mapping->data	= NULL;
+	mapping->length = (size_t)st.st_size;
+	mapping->flags	= flags;
+
+	// mmap refuse une longueur nulle : un fichier vide donne data == NULL
+	if (mapping->length > 0) {
+		int map_flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+		if (flags & FS_MAP_POPULATE)
+			map_flags |= MAP_POPULATE;
+#endif
+		void *data = mmap(NULL, mapping->length, PROT_READ | (writable ? PROT_WRITE : 0), map_flags, fd, 0);
+		if (data == MAP_FAILED) {
+			int saved_errno = errno;
+			free(mapping);
+			close(fd);
+			errno = saved_errno;
+			return NULL;
+		}
+		mapping->data = data;
+		fs_map_advise(mapping);
+	}
+
+	// Le mapping garde sa propre référence sur le fichier
+	close(fd);
+	return mapping;
+}
+
+int fs_map_sync(t_mapping *mapping) {
+	if (!mapping)
+		return FS_ERROR;
+	if (!(mapping->flags & FS_MAP_WRITE) || !mapping->data)
+		return FS_SUCCESS;
+	return msync(mapping->data, mapping->length, MS_SYNC) == 0 ? FS_SUCCESS : FS_ERROR_FILE_WRITE;
+}
+
+int fs_unmap(t_mapping *mapping) {
+	if (!mapping)
+		return FS_ERROR;
+
+	int ret = FS_SUCCESS;
+	if (mapping->data && munmap(mapping->data, mapping->length) != 0)
+		ret = FS_ERROR;
+	free(mapping);
+	return ret;
+}
+
 // --------------------------------------------------------------------------
 // Directory Operations
 // --------------------------------------------------------------------------
@@ -302,6 +456,13 @@ uint32_t fs_get_size(const char *path) {
 	return st.st_size;
 }
 
+off_t fs_get_size64(const char *path) {
+	struct stat st;
+	if (stat(path, &st) < 0)
+		return FS_ERROR;
+	return st.st_size;
+}
+
 bool fs_is_directory(const char *path) {
 	struct stat st;
 	if (stat(path, &st) < 0)
@@ -346,6 +507,88 @@ int fs_mkdir_p(const char *path, mode_t mode) {
 // --------------------------------------------------------------------------
 // Utility Operations
 // --------------------------------------------------------------------------
+
+/*
+ * Étapes de fs_copy, de la plus rapide à la plus générale. Chacune repart des
+ * offsets courants des deux descripteurs et renvoie 1 si la copie est
+ * terminée, 0 si le noyau ne la prend pas en charge (l'étape suivante
+ * continue là où elle s'est arrêtée), ou un code FS_* en cas d'erreur.
+ */
+#ifdef __linux__
+static bool fs_copy_unsupported(int error) {
+	return error == EXDEV || error == EINVAL || error == ENOSYS || error == EOPNOTSUPP || error == EBADF ||
+		   error == EPERM || error == ETXTBSY;
+}
+
+static int fs_copy_reflink(int in_fd, int out_fd) {
+#ifdef FICLONE
+	// Partage des extents (Btrfs, XFS...) : aucune donnée n'est recopiée
+	if (ioctl(out_fd, FICLONE, in_fd) == 0)
+		return 1;
+#else
+	(void)in_fd;
+	(void)out_fd;
+#endif
+	return 0;
+}
+
+static int fs_copy_kernel_range(int in_fd, int out_fd) {
+	bool copied = false;
+	while (true) {
+		ssize_t n = copy_file_range(in_fd, NULL, out_fd, NULL, FS_COPY_CHUNK, 0);
+		if (n > 0)
+			copied = true;
+		else if (n == 0) // Fin de fichier, ou fichier virtuel (procfs) sans taille
+			return copied ? 1 : 0;
+		else if (errno != EINTR)
+			return fs_copy_unsupported(errno) ? 0 : FS_ERROR;
+	}
+}
+
+static int fs_copy_sendfile(int in_fd, int out_fd) {
+	bool copied = false;
+	while (true) {
+		ssize_t n = sendfile(out_fd, in_fd, NULL, FS_COPY_CHUNK);
+		if (n > 0)
+			copied = true;
+		else if (n == 0)
+			return copied ? 1 : 0;
+		else if (errno != EINTR)
+			return fs_copy_unsupported(errno) ? 0 : FS_ERROR;
+	}
+}
+#endif
+
+static int fs_copy_buffered(int in_fd, int out_fd) {
+	void *buffer = NULL;
+	if (posix_memalign(&buffer, FS_COPY_BUFFER_ALIGN, FS_COPY_BUFFER_SIZE) != 0)
+		return FS_ERROR_MEMORY_ALLOCATION;
+
+	int ret = 1;
+	while (ret == 1) {
+		ssize_t bytes_read = read(in_fd, buffer, FS_COPY_BUFFER_SIZE);
+		if (bytes_read == 0)
+			break;
+		if (bytes_read < 0) {
+			if (errno != EINTR)
+				ret = FS_ERROR_FILE_READ;
+			continue;
+		}
+		ssize_t total_written = 0;
+		while (total_written < bytes_read) {
+			ssize_t n = write(out_fd, (char *)buffer + total_written, bytes_read - total_written);
+			if (n < 0 && errno != EINTR) {
+				ret = FS_ERROR;
+				break;
+			}
+			if (n > 0)
+				total_written += n;
+		}
+	}
+	free(buffer);
+	return ret;
+}
+
 int fs_copy(const char *src, const char *dst) {
 	if (!fs_exists(src))
 		return FS_NOT_FOUND;
@@ -366,18 +609,20 @@ int fs_copy(const char *src, const char *dst) {
 	if (src_file->metadata)
 		fs_set_permissions(dst, src_file->metadata->permissions);
 
-	char buffer[4096];
-	int bytes_read = 0;
-	int ret		   = FS_SUCCESS;
-	while ((bytes_read = fs_read(src_file, buffer, sizeof(buffer))) > 0) {
-		if (fs_write(dst_file, buffer, bytes_read) != bytes_read) {
-			ret = FS_ERROR;
-			break;
-		}
-	}
-	// Si la lecture s'est terminée sur une erreur, la propager
-	if (bytes_read < 0)
-		ret = FS_ERROR_FILE_READ;
+	// Reflink, puis copie dans le noyau, puis tampon en espace utilisateur
+	int ret = src_file->is_directory ? FS_ERROR_FILE_READ : 0;
+#ifdef __linux__
+	if (ret == 0)
+		ret = fs_copy_reflink(src_file->fd, dst_file->fd);
+	if (ret == 0)
+		ret = fs_copy_kernel_range(src_file->fd, dst_file->fd);
+	if (ret == 0)
+		ret = fs_copy_sendfile(src_file->fd, dst_file->fd);
+#endif
+	if (ret == 0)
+		ret = fs_copy_buffered(src_file->fd, dst_file->fd);
+	if (ret == 1)
+		ret = FS_SUCCESS;
 
 	fs_close(src_file);
 	fs_close(dst_file);
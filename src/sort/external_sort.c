@@ -0,0 +1,448 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   external_sort.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <lib/filesystem/filesystem.h>
+#include <lib/sort/sort.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Memory budget used when the caller passes 0 */
+#define EXTERNAL_DEFAULT_MEMORY ((size_t)256 << 20)
+
+/* Smallest per-run read buffer; bounds the merge fan-in */
+#define EXTERNAL_MIN_BUFFER ((size_t)1 << 20)
+
+typedef struct RunList
+{
+    char **paths;
+    size_t count;
+    size_t capacity;
+} RunList;
+
+typedef struct RunStream
+{
+    t_file *file;
+    unsigned char *buffer;
+    size_t capacity;
+    size_t count;
+    size_t pos;
+    bool done;
+} RunStream;
+
+typedef struct Merger
+{
+    RunStream *streams;
+    size_t *tree;
+    size_t k;
+    size_t record_size;
+    int (*compare)(const void *, const void *);
+} Merger;
+
+static int read_full(t_file *file, unsigned char *buffer, size_t bytes, size_t *got)
+{
+    *got = 0;
+    while (*got < bytes)
+    {
+        ssize_t n = fs_read64(file, buffer + *got, bytes - *got);
+
+        if (n < 0)
+            return FS_ERROR_FILE_READ;
+        if (n == 0)
+            break;
+        *got += (size_t)n;
+    }
+    return FS_SUCCESS;
+}
+
+static int write_full(t_file *file, const unsigned char *buffer, size_t bytes)
+{
+    ssize_t n = fs_write64(file, buffer, bytes);
+
+    if (n < 0 || (size_t)n != bytes)
+        return FS_ERROR_FILE_WRITE;
+    return FS_SUCCESS;
+}
+
+static void run_list_free(RunList *runs)
+{
+    for (size_t i = 0; i < runs->count; i++)
+    {
+        fs_delete(runs->paths[i]);
+        free(runs->paths[i]);
+    }
+    free(runs->paths);
+    runs->paths = NULL;
+    runs->count = 0;
+    runs->capacity = 0;
+}
+
+/**
+ * @brief Creates an empty temporary run file and records its path.
+ */
+static t_file *run_list_create(RunList *runs, const char *tmp_dir)
+{
+    char *path;
+    int fd;
+    t_file *file;
+
+    if (runs->count == runs->capacity)
+    {
+        size_t capacity = runs->capacity ? runs->capacity * 2 : 16;
+        char **paths = realloc(runs->paths, capacity * sizeof(char *));
+        if (!paths)
+            return NULL;
+        runs->paths = paths;
+        runs->capacity = capacity;
+    }
+
+    path = malloc(PATH_MAX);
+    if (!path)
+        return NULL;
+    snprintf(path, PATH_MAX, "%s/hypercore_sort_XXXXXX", tmp_dir);
+    fd = mkstemp(path);
+    if (fd < 0)
+    {
+        free(path);
+        return NULL;
+    }
+    close(fd);
+
+    file = fs_open(path, O_WRONLY | O_TRUNC);
+    if (!file)
+    {
+        fs_delete(path);
+        free(path);
+        return NULL;
+    }
+    runs->paths[runs->count++] = path;
+    return file;
+}
+
+static int stream_fill(RunStream *stream, size_t record_size)
+{
+    size_t got;
+    int ret = read_full(stream->file, stream->buffer, stream->capacity * record_size, &got);
+
+    if (ret != FS_SUCCESS)
+        return ret;
+    if (got % record_size)
+        return FS_ERROR_FILE_READ;
+    stream->count = got / record_size;
+    stream->pos = 0;
+    stream->done = (stream->count == 0);
+    return FS_SUCCESS;
+}
+
+/**
+ * @brief Tournament order: exhausted runs lose, ties go to the lower run
+ *        index, which keeps the whole sort stable.
+ */
+static bool beats(const Merger *merger, size_t a, size_t b)
+{
+    const RunStream *sa = &merger->streams[a];
+    const RunStream *sb = &merger->streams[b];
+    int cmp;
+
+    if (sa->done || sb->done)
+        return sb->done && (!sa->done || a < b);
+    cmp = merger->compare(sa->buffer + sa->pos * merger->record_size,
+                          sb->buffer + sb->pos * merger->record_size);
+    return cmp < 0 || (cmp == 0 && a < b);
+}
+
+/**
+ * @brief Builds the loser tree: leaves sit at k..2k-1, internal node n
+ *        keeps the loser of its subtree's final, tree[0] the overall winner.
+ */
+static bool loser_tree_build(Merger *merger)
+{
+    size_t k = merger->k;
+    size_t *winners = malloc(2 * k * sizeof(size_t));
+
+    if (!winners)
+        return false;
+    for (size_t i = 0; i < k; i++)
+        winners[k + i] = i;
+    for (size_t n = k - 1; n >= 1; n--)
+    {
+        size_t left = winners[2 * n];
+        size_t right = winners[2 * n + 1];
+        bool left_wins = beats(merger, left, right);
+
+        winners[n] = left_wins ? left : right;
+        merger->tree[n] = left_wins ? right : left;
+    }
+    merger->tree[0] = (k > 1) ? winners[1] : 0;
+    free(winners);
+    return true;
+}
+
+/**
+ * @brief Replays the matches on the path from a leaf to the root after its
+ *        run advanced: log2(k) comparisons per output record.
+ */
+static void loser_tree_replay(Merger *merger, size_t leaf)
+{
+    size_t winner = leaf;
+
+    for (size_t n = (leaf + merger->k) / 2; n >= 1; n /= 2)
+    {
+        if (beats(merger, merger->tree[n], winner))
+        {
+            size_t tmp = merger->tree[n];
+            merger->tree[n] = winner;
+            winner = tmp;
+        }
+    }
+    merger->tree[0] = winner;
+}
+
+/**
+ * @brief K-way merges the given run files into out through buffers of
+ *        buffer_bytes each.
+ */
+static int merge_runs(char **paths, size_t k, t_file *out, size_t record_size,
+                      int (*compare)(const void *, const void *), size_t buffer_bytes)
+{
+    Merger merger = {0};
+    size_t records = buffer_bytes / record_size;
+    unsigned char *out_buffer = NULL;
+    size_t out_count = 0;
+    int ret = FS_ERROR_MEMORY_ALLOCATION;
+
+    if (records == 0)
+        records = 1;
+    merger.k = k;
+    merger.record_size = record_size;
+    merger.compare = compare;
+    merger.streams = calloc(k, sizeof(RunStream));
+    merger.tree = malloc(k * sizeof(size_t));
+    out_buffer = malloc(records * record_size);
+    if (!merger.streams || !merger.tree || !out_buffer)
+        goto cleanup;
+
+    for (size_t i = 0; i < k; i++)
+    {
+        RunStream *stream = &merger.streams[i];
+
+        stream->capacity = records;
+        stream->buffer = malloc(records * record_size);
+        if (!stream->buffer)
+            goto cleanup;
+        stream->file = fs_open(paths[i], O_RDONLY);
+        if (!stream->file)
+        {
+            ret = FS_ERROR_FILE_OPEN;
+            goto cleanup;
+        }
+        if ((ret = stream_fill(stream, record_size)) != FS_SUCCESS)
+            goto cleanup;
+    }
+
+    ret = FS_ERROR_MEMORY_ALLOCATION;
+    if (!loser_tree_build(&merger))
+        goto cleanup;
+
+    ret = FS_SUCCESS;
+    while (!merger.streams[merger.tree[0]].done)
+    {
+        size_t w = merger.tree[0];
+        RunStream *stream = &merger.streams[w];
+
+        memcpy(out_buffer + out_count * record_size,
+               stream->buffer + stream->pos * record_size, record_size);
+        if (++out_count == records)
+        {
+            if ((ret = write_full(out, out_buffer, out_count * record_size)) != FS_SUCCESS)
+                goto cleanup;
+            out_count = 0;
+        }
+        if (++stream->pos == stream->count
+            && (ret = stream_fill(stream, record_size)) != FS_SUCCESS)
+            goto cleanup;
+        loser_tree_replay(&merger, w);
+    }
+    ret = write_full(out, out_buffer, out_count * record_size);
+
+cleanup:
+    if (merger.streams)
+    {
+        for (size_t i = 0; i < k; i++)
+        {
+            if (merger.streams[i].file)
+                fs_close(merger.streams[i].file);
+            free(merger.streams[i].buffer);
+        }
+    }
+    free(merger.streams);
+    free(merger.tree);
+    free(out_buffer);
+    return ret;
+}
+
+/**
+ * @brief Splits the input into sorted runs. If the whole input fits in
+ *        one chunk it is written straight to output and no run is created.
+ */
+static int create_runs(t_file *in, const char *output, RunList *runs, size_t record_size,
+                       int (*compare)(const void *, const void *), size_t memory_limit,
+                       const char *tmp_dir, bool *done)
+{
+    // parallel_sort needs a scratch buffer as large as the chunk
+    size_t records = memory_limit / 2 / record_size;
+    unsigned char *chunk;
+    int ret = FS_SUCCESS;
+
+    *done = false;
+    if (records == 0)
+        records = 1;
+    chunk = malloc(records * record_size);
+    if (!chunk)
+        return FS_ERROR_MEMORY_ALLOCATION;
+
+    for (;;)
+    {
+        size_t got, count;
+        t_file *run;
+
+        if ((ret = read_full(in, chunk, records * record_size, &got)) != FS_SUCCESS)
+            break;
+        if (got % record_size)
+        {
+            ret = FS_ERROR_FILE_READ;
+            break;
+        }
+        count = got / record_size;
+        if (count == 0 && runs->count > 0)
+            break;
+        parallel_sort(chunk, count, record_size, compare);
+
+        if (runs->count == 0 && count < records)
+        {
+            t_file *out = fs_open(output, O_WRONLY | O_CREAT | O_TRUNC);
+            if (!out)
+            {
+                ret = FS_ERROR_FILE_OPEN;
+                break;
+            }
+            ret = write_full(out, chunk, got);
+            fs_close(out);
+            *done = true;
+            break;
+        }
+
+        if (!(run = run_list_create(runs, tmp_dir)))
+        {
+            ret = FS_ERROR_FILE_OPEN;
+            break;
+        }
+        ret = write_full(run, chunk, got);
+        fs_close(run);
+        if (ret != FS_SUCCESS || count < records)
+            break;
+    }
+    free(chunk);
+    return ret;
+}
+
+/**
+ * @brief Sorts a file of fixed-size binary records that may not fit in memory
+ *
+ * Chunks of the input that fit in half of memory_limit are sorted with
+ * parallel_sort() and spilled to temporary run files. The runs are then
+ * k-way merged through a loser tree with large sequential buffers. If there
+ * are more runs than the memory budget can buffer, they are merged in
+ * several passes. Equal records keep their input order.
+ *
+ * @param input Path of the file to sort
+ * @param output Path of the sorted file (may be the same as input)
+ * @param record_size Size of each record in bytes
+ * @param compare Comparison function to use
+ * @param memory_limit Memory budget in bytes, 0 for a 256 MB default
+ * @param tmp_dir Directory for run files, NULL for $TMPDIR or /tmp
+ * @return int FS_SUCCESS, or an FS_* error code. Temporary files are
+ *         removed in every case.
+ */
+int external_sort(const char *input, const char *output, size_t record_size,
+                  int (*compare)(const void *, const void *),
+                  size_t memory_limit, const char *tmp_dir)
+{
+    RunList runs = {0};
+    t_file *in;
+    size_t fan_in;
+    bool done;
+    int ret;
+
+    if (!input || !output || !record_size || !compare)
+        return FS_ERROR;
+    if (!memory_limit)
+        memory_limit = EXTERNAL_DEFAULT_MEMORY;
+    if (!tmp_dir && !(tmp_dir = getenv("TMPDIR")))
+        tmp_dir = "/tmp";
+
+    if (!(in = fs_open(input, O_RDONLY)))
+        return fs_exists(input) ? FS_ERROR_FILE_OPEN : FS_NOT_FOUND;
+    ret = create_runs(in, output, &runs, record_size, compare, memory_limit, tmp_dir, &done);
+    fs_close(in);
+    if (ret != FS_SUCCESS || done)
+    {
+        run_list_free(&runs);
+        return ret;
+    }
+
+    // One buffer per input run plus one for the output
+    fan_in = memory_limit / EXTERNAL_MIN_BUFFER;
+    fan_in = (fan_in > 3) ? fan_in - 1 : 2;
+
+    // Intermediate passes: merge consecutive groups until one pass is enough
+    while (runs.count > fan_in)
+    {
+        RunList next = {0};
+
+        for (size_t start = 0; start < runs.count && ret == FS_SUCCESS; start += fan_in)
+        {
+            size_t k = (runs.count - start < fan_in) ? runs.count - start : fan_in;
+            t_file *out = run_list_create(&next, tmp_dir);
+
+            if (!out)
+            {
+                ret = FS_ERROR_FILE_OPEN;
+                break;
+            }
+            ret = merge_runs(runs.paths + start, k, out, record_size, compare,
+                             memory_limit / (k + 1));
+            fs_close(out);
+        }
+        run_list_free(&runs);
+        runs = next;
+        if (ret != FS_SUCCESS)
+        {
+            run_list_free(&runs);
+            return ret;
+        }
+    }
+
+    t_file *out = fs_open(output, O_WRONLY | O_CREAT | O_TRUNC);
+    if (!out)
+        ret = FS_ERROR_FILE_OPEN;
+    else
+    {
+        ret = merge_runs(runs.paths, runs.count, out, record_size, compare,
+                         memory_limit / (runs.count + 1));
+        fs_close(out);
+    }
+    run_list_free(&runs);
+    return ret;
+}
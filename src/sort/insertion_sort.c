@@ -6,10 +6,11 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/14 11:11:35 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/03/14 11:18:50 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
+#include <lib/algorithms/compare.h>
 #include <lib/sort/sort.h>
 #include <string.h>
 
@@ -29,7 +30,15 @@ void insertion_sort(void *array, size_t size, size_t elem_size,
     int j;
     size_t i;
 
-    if (!array || size < 2 || !compare || !(key = (unsigned char *)malloc(elem_size)))
+    if (!array || size < 2 || !compare)
+        return;
+
+    // Same rule as merge_sort: typed kernels only where stability is moot
+    if (compare != compare_float && compare != compare_double
+        && sort_typed(array, size, elem_size, compare))
+        return;
+
+    if (!(key = (unsigned char *)malloc(elem_size)))
         return;
 
     for (i = 1; i < size; i++)
@@ -6,10 +6,11 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/14 11:11:35 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/03/14 11:18:48 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
+#include <lib/algorithms/compare.h>
 #include <lib/sort/sort.h>
 #include <stdlib.h>
 #include <string.h>
@@ -111,6 +112,12 @@ void merge_sort(void *array, size_t size, size_t elem_size,
 {
     if (!array || size < 2 || !compare)
         return;
+
+    // Equal integers are indistinguishable, so the unstable typed kernel is
+    // safe; equal floats are not (+0.0 / -0.0) and keep the stable path
+    if (compare != compare_float && compare != compare_double
+        && sort_typed(array, size, elem_size, compare))
+        return;
         
     merge_sort_recursive((unsigned char *)array, 0, size - 1, elem_size, compare);
 }
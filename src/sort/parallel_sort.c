@@ -0,0 +1,423 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   parallel_sort.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <lib/sort/sort.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Below this many elements per thread, splitting costs more than it saves */
+#define PARALLEL_MIN_CHUNK 16384
+
+/* Runs shorter than this are sorted by insertion */
+#define INSERTION_THRESHOLD 16
+
+/* 0 means "one thread per online CPU" */
+static size_t default_threads = 0;
+
+typedef struct SortJob
+{
+    unsigned char *array;
+    unsigned char *buffer;
+    unsigned char *src;
+    unsigned char *dst;
+    size_t size;
+    size_t elem_size;
+    int (*compare)(const void *, const void *);
+    size_t threads;
+    size_t *runs;
+    size_t run_count;
+} SortJob;
+
+typedef struct SortWorker
+{
+    SortJob *job;
+    size_t id;
+} SortWorker;
+
+/**
+ * @brief Copies one element. Word-sized elements get a single load/store
+ *        instead of a memcpy call of unknown length.
+ */
+static inline void copy_elem(unsigned char *dst, const unsigned char *src, size_t elem_size)
+{
+    switch (elem_size)
+    {
+        case 4:
+            memcpy(dst, src, 4);
+            break;
+        case 8:
+            memcpy(dst, src, 8);
+            break;
+        case 16:
+            memcpy(dst, src, 16);
+            break;
+        default:
+            memcpy(dst, src, elem_size);
+    }
+}
+
+static void swap_bytes(unsigned char *a, unsigned char *b, size_t elem_size)
+{
+    unsigned char tmp;
+
+    while (elem_size--)
+    {
+        tmp = *a;
+        *a++ = *b;
+        *b++ = tmp;
+    }
+}
+
+static void insertion_run(unsigned char *arr, size_t n, size_t elem_size,
+                          int (*compare)(const void *, const void *))
+{
+    for (size_t i = 1; i < n; i++)
+    {
+        size_t j = i;
+        while (j > 0 && compare(arr + (j - 1) * elem_size, arr + j * elem_size) > 0)
+        {
+            swap_bytes(arr + (j - 1) * elem_size, arr + j * elem_size, elem_size);
+            j--;
+        }
+    }
+}
+
+/**
+ * @brief Stable top-down merge sort of arr[0..n) using tmp (at least n / 2
+ *        elements) as scratch space. The result is left in arr.
+ */
+static void merge_sort_run(unsigned char *arr, unsigned char *tmp, size_t n,
+                           size_t elem_size, int (*compare)(const void *, const void *))
+{
+    size_t mid, i, j, k;
+
+    if (n <= INSERTION_THRESHOLD)
+    {
+        insertion_run(arr, n, elem_size, compare);
+        return;
+    }
+
+    mid = n / 2;
+    merge_sort_run(arr, tmp, mid, elem_size, compare);
+    merge_sort_run(arr + mid * elem_size, tmp, n - mid, elem_size, compare);
+
+    // Halves already in order, nothing to merge
+    if (compare(arr + (mid - 1) * elem_size, arr + mid * elem_size) <= 0)
+        return;
+
+    memcpy(tmp, arr, mid * elem_size);
+    i = 0;
+    j = mid;
+    k = 0;
+    while (i < mid && j < n)
+    {
+        if (compare(tmp + i * elem_size, arr + j * elem_size) <= 0)
+            copy_elem(arr + k++ * elem_size, tmp + i++ * elem_size, elem_size);
+        else
+            copy_elem(arr + k++ * elem_size, arr + j++ * elem_size, elem_size);
+    }
+    if (i < mid)
+        memcpy(arr + k * elem_size, tmp + i * elem_size, (mid - i) * elem_size);
+}
+
+/**
+ * @brief Finds how many elements of a take part in the first k elements of
+ *        the stable merge of a and b (merge path co-ranking).
+ */
+static size_t co_rank(size_t k, const unsigned char *a, size_t na,
+                      const unsigned char *b, size_t nb, size_t elem_size,
+                      int (*compare)(const void *, const void *))
+{
+    size_t lo = (k > nb) ? k - nb : 0;
+    size_t hi = (k < na) ? k : na;
+
+    // Largest i such that a[i - 1] <= b[k - i]
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (compare(a + (mid - 1) * elem_size, b + (k - mid) * elem_size) <= 0)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+static void merge_into(unsigned char *dst, const unsigned char *a, size_t na,
+                       const unsigned char *b, size_t nb, size_t elem_size,
+                       int (*compare)(const void *, const void *))
+{
+    while (na && nb)
+    {
+        if (compare(a, b) <= 0)
+        {
+            copy_elem(dst, a, elem_size);
+            a += elem_size;
+            na--;
+        }
+        else
+        {
+            copy_elem(dst, b, elem_size);
+            b += elem_size;
+            nb--;
+        }
+        dst += elem_size;
+    }
+    if (na)
+        memcpy(dst, a, na * elem_size);
+    if (nb)
+        memcpy(dst, b, nb * elem_size);
+}
+
+static void *sort_chunk_worker(void *arg)
+{
+    SortWorker *worker = arg;
+    SortJob *job = worker->job;
+    size_t start = job->runs[worker->id];
+    size_t end = job->runs[worker->id + 1];
+
+    merge_sort_run(job->array + start * job->elem_size,
+                   job->buffer + start * job->elem_size,
+                   end - start, job->elem_size, job->compare);
+    return NULL;
+}
+
+/**
+ * @brief Merges one round of run pairs from src into dst. Each worker owns
+ *        an equal slice of the output, whatever the run boundaries are, so
+ *        every round keeps all threads busy.
+ */
+static void *merge_round_worker(void *arg)
+{
+    SortWorker *worker = arg;
+    SortJob *job = worker->job;
+    size_t es = job->elem_size;
+    size_t lo = job->size * worker->id / job->threads;
+    size_t hi = job->size * (worker->id + 1) / job->threads;
+
+    for (size_t p = 0; p < job->run_count && lo < hi; p += 2)
+    {
+        size_t a_start = job->runs[p];
+        size_t b_start = job->runs[p + 1];
+        size_t b_end = (p + 1 < job->run_count) ? job->runs[p + 2] : b_start;
+        size_t s, e, i1, i2;
+
+        if (b_end <= lo || a_start >= hi)
+            continue;
+        s = (lo > a_start) ? lo : a_start;
+        e = (hi < b_end) ? hi : b_end;
+
+        // Trailing unpaired run: plain copy
+        if (p + 1 >= job->run_count)
+        {
+            memcpy(job->dst + s * es, job->src + s * es, (e - s) * es);
+            continue;
+        }
+
+        i1 = co_rank(s - a_start, job->src + a_start * es, b_start - a_start,
+                     job->src + b_start * es, b_end - b_start, es, job->compare);
+        i2 = co_rank(e - a_start, job->src + a_start * es, b_start - a_start,
+                     job->src + b_start * es, b_end - b_start, es, job->compare);
+        merge_into(job->dst + s * es,
+                   job->src + (a_start + i1) * es, i2 - i1,
+                   job->src + (b_start + (s - a_start - i1)) * es,
+                   (e - s) - (i2 - i1), es, job->compare);
+    }
+    return NULL;
+}
+
+static void *copy_back_worker(void *arg)
+{
+    SortWorker *worker = arg;
+    SortJob *job = worker->job;
+    size_t lo = job->size * worker->id / job->threads;
+    size_t hi = job->size * (worker->id + 1) / job->threads;
+
+    memcpy(job->array + lo * job->elem_size, job->buffer + lo * job->elem_size,
+           (hi - lo) * job->elem_size);
+    return NULL;
+}
+
+/**
+ * @brief Runs one fork-join phase: worker 0 runs on the calling thread, the
+ *        others on fresh threads. A worker whose thread cannot be created is
+ *        run inline, so a phase always completes.
+ */
+static void run_phase(SortWorker *workers, pthread_t *tids, bool *started,
+                      size_t threads, void *(*routine)(void *))
+{
+    for (size_t t = 1; t < threads; t++)
+        started[t] = pthread_create(&tids[t], NULL, routine, &workers[t]) == 0;
+
+    routine(&workers[0]);
+
+    for (size_t t = 1; t < threads; t++)
+    {
+        if (started[t])
+            pthread_join(tids[t], NULL);
+        else
+            routine(&workers[t]);
+    }
+}
+
+static size_t resolve_threads(size_t threads, size_t size)
+{
+    if (threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (size_t)cpus : 1;
+    }
+    if (threads > size / PARALLEL_MIN_CHUNK)
+        threads = size / PARALLEL_MIN_CHUNK;
+    return (threads > 0) ? threads : 1;
+}
+
+/**
+ * @brief Sets the number of threads used by parallel_sort()
+ *
+ * @param threads Thread count, 0 to use one thread per online CPU
+ */
+void parallel_sort_set_threads(size_t threads)
+{
+    default_threads = threads;
+}
+
+/**
+ * @brief Returns the thread count configured for parallel_sort()
+ *
+ * @return size_t Configured thread count, 0 meaning one per online CPU
+ */
+size_t parallel_sort_get_threads(void)
+{
+    return default_threads;
+}
+
+/**
+ * @brief Implements a stable parallel merge sort with an explicit thread count
+ *
+ * The array is cut into one chunk per thread, each chunk is merge sorted
+ * concurrently, then the sorted runs are merged pairwise. Every merge round
+ * splits its output evenly between all threads using merge path
+ * co-ranking, so the work stays balanced until the last round.
+ *
+ * @param array Pointer to the array to be sorted
+ * @param size Number of elements in the array
+ * @param elem_size Size of each element in bytes
+ * @param compare Comparison function to use
+ * @param threads Number of threads, 0 to use one thread per online CPU
+ *
+ * @note Needs a scratch buffer as large as the array. If it cannot be
+ *       allocated, falls back to merge_sort().
+ */
+void parallel_sort_threads(void *array, size_t size, size_t elem_size,
+                           int (*compare)(const void *, const void *), size_t threads)
+{
+    SortJob job;
+    SortWorker *workers;
+    pthread_t *tids;
+    bool *started;
+    unsigned char *buffer;
+
+    if (!array || size < 2 || !compare || !elem_size)
+        return;
+
+    threads = resolve_threads(threads, size);
+    buffer = malloc(size * elem_size);
+    if (!buffer)
+    {
+        merge_sort(array, size, elem_size, compare);
+        return;
+    }
+
+    if (threads == 1)
+    {
+        merge_sort_run(array, buffer, size, elem_size, compare);
+        free(buffer);
+        return;
+    }
+
+    workers = malloc(threads * sizeof(*workers));
+    tids = malloc(threads * sizeof(*tids));
+    started = malloc(threads * sizeof(*started));
+    job.runs = malloc((threads + 1) * sizeof(*job.runs));
+    if (!workers || !tids || !started || !job.runs)
+    {
+        merge_sort_run(array, buffer, size, elem_size, compare);
+        goto cleanup;
+    }
+
+    job.array = array;
+    job.buffer = buffer;
+    job.size = size;
+    job.elem_size = elem_size;
+    job.compare = compare;
+    job.threads = threads;
+    job.run_count = threads;
+    for (size_t t = 0; t < threads; t++)
+    {
+        workers[t].job = &job;
+        workers[t].id = t;
+        job.runs[t] = size * t / threads;
+    }
+    job.runs[threads] = size;
+
+    // Phase 1: sort one chunk per thread, in place
+    run_phase(workers, tids, started, threads, sort_chunk_worker);
+
+    // Phase 2: merge runs pairwise, ping-ponging between array and buffer
+    job.src = job.array;
+    job.dst = job.buffer;
+    while (job.run_count > 1)
+    {
+        unsigned char *swap;
+
+        run_phase(workers, tids, started, threads, merge_round_worker);
+        for (size_t r = 0; 2 * r < job.run_count; r++)
+            job.runs[r] = job.runs[2 * r];
+        job.run_count = (job.run_count + 1) / 2;
+        job.runs[job.run_count] = size;
+
+        swap = job.src;
+        job.src = job.dst;
+        job.dst = swap;
+    }
+
+    if (job.src != job.array)
+        run_phase(workers, tids, started, threads, copy_back_worker);
+
+cleanup:
+    free(workers);
+    free(tids);
+    free(started);
+    free(job.runs);
+    free(buffer);
+}
+
+/**
+ * @brief Implements a stable parallel merge sort
+ *
+ * Uses the thread count set with parallel_sort_set_threads(). Small arrays
+ * are sorted on the calling thread.
+ *
+ * @param array Pointer to the array to be sorted
+ * @param size Number of elements in the array
+ * @param elem_size Size of each element in bytes
+ * @param compare Comparison function to use
+ */
+void parallel_sort(void *array, size_t size, size_t elem_size,
+                   int (*compare)(const void *, const void *))
+{
+    parallel_sort_threads(array, size, elem_size, compare, default_threads);
+}
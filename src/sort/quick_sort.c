@@ -6,7 +6,7 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/03/14 11:11:35 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/03/14 11:18:49 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -78,6 +78,10 @@ void quick_sort(void *array, size_t size, size_t elem_size,
 {
     if (!array || size < 2 || !compare)
         return;
+
+    // Known scalar comparators get an inlined, comparator-free kernel
+    if (sort_typed(array, size, elem_size, compare))
+        return;
         
     quick_sort_recursive((unsigned char *)array, 0, size - 1, elem_size, compare);
 }
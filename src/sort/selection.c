@@ -0,0 +1,334 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   selection.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <lib/sort/sort.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Ranges this short are finished by insertion sort */
+#define SELECT_INSERTION_THRESHOLD 16
+
+#define AT(arr, i, elem_size) ((arr) + (i) * (elem_size))
+
+static void swap_bytes(unsigned char *a, unsigned char *b, size_t elem_size)
+{
+    unsigned char tmp;
+
+    if (a == b)
+        return;
+    while (elem_size--)
+    {
+        tmp = *a;
+        *a++ = *b;
+        *b++ = tmp;
+    }
+}
+
+static void insertion_range(unsigned char *arr, size_t n, size_t elem_size,
+                            int (*compare)(const void *, const void *))
+{
+    for (size_t i = 1; i < n; i++)
+        for (size_t j = i; j > 0 && compare(AT(arr, j - 1, elem_size), AT(arr, j, elem_size)) > 0; j--)
+            swap_bytes(AT(arr, j - 1, elem_size), AT(arr, j, elem_size), elem_size);
+}
+
+/**
+ * @brief Restores the heap property below root. sign = 1 builds a max-heap,
+ *        sign = -1 a min-heap.
+ */
+static void sift_down(unsigned char *arr, size_t root, size_t n, size_t elem_size,
+                      int (*compare)(const void *, const void *), int sign)
+{
+    size_t child;
+
+    while ((child = 2 * root + 1) < n)
+    {
+        if (child + 1 < n
+            && sign * compare(AT(arr, child + 1, elem_size), AT(arr, child, elem_size)) > 0)
+            child++;
+        if (sign * compare(AT(arr, child, elem_size), AT(arr, root, elem_size)) <= 0)
+            break;
+        swap_bytes(AT(arr, root, elem_size), AT(arr, child, elem_size), elem_size);
+        root = child;
+    }
+}
+
+static void sift_up(unsigned char *arr, size_t node, size_t elem_size,
+                    int (*compare)(const void *, const void *), int sign)
+{
+    while (node > 0)
+    {
+        size_t parent = (node - 1) / 2;
+
+        if (sign * compare(AT(arr, node, elem_size), AT(arr, parent, elem_size)) <= 0)
+            break;
+        swap_bytes(AT(arr, node, elem_size), AT(arr, parent, elem_size), elem_size);
+        node = parent;
+    }
+}
+
+/**
+ * @brief Heapsort of arr[0..n). With a max-heap (sign = 1) the result is
+ *        ascending, with a min-heap (sign = -1) descending.
+ */
+static void heap_sort_range(unsigned char *arr, size_t n, size_t elem_size,
+                            int (*compare)(const void *, const void *), int sign)
+{
+    for (size_t i = n / 2; i-- > 0;)
+        sift_down(arr, i, n, elem_size, compare, sign);
+    while (n > 1)
+    {
+        swap_bytes(arr, AT(arr, --n, elem_size), elem_size);
+        sift_down(arr, 0, n, elem_size, compare, sign);
+    }
+}
+
+/**
+ * @brief Fallback once introselect runs out of depth: keeps the nth + 1
+ *        smallest elements in a max-heap, whose root is then the answer.
+ *        O(n log nth) whatever the input.
+ */
+static void heap_select(unsigned char *arr, size_t n, size_t nth, size_t elem_size,
+                        int (*compare)(const void *, const void *))
+{
+    size_t heap = nth + 1;
+
+    for (size_t i = heap / 2; i-- > 0;)
+        sift_down(arr, i, heap, elem_size, compare, 1);
+    for (size_t i = heap; i < n; i++)
+    {
+        if (compare(AT(arr, i, elem_size), arr) < 0)
+        {
+            swap_bytes(AT(arr, i, elem_size), arr, elem_size);
+            sift_down(arr, 0, heap, elem_size, compare, 1);
+        }
+    }
+    swap_bytes(arr, AT(arr, nth, elem_size), elem_size);
+}
+
+static int floor_log2(size_t n)
+{
+    int log = 0;
+
+    while (n >>= 1)
+        log++;
+    return log;
+}
+
+/**
+ * @brief Partially sorts an array so that the nth element is in place
+ *
+ * After the call, array[nth] holds the element that would be there if the
+ * whole array were sorted, no element before it compares greater and no
+ * element after it compares smaller. Uses introselect: quickselect with a
+ * median-of-3 pivot, switching to heap selection if partitions keep being
+ * unbalanced, so the average cost is O(n) and the worst case O(n log n).
+ *
+ * @param array Pointer to the array
+ * @param size Number of elements in the array
+ * @param nth Index of the element to place (must be < size)
+ * @param elem_size Size of each element in bytes
+ * @param compare Comparison function to use
+ */
+void nth_element(void *array, size_t size, size_t nth, size_t elem_size,
+                 int (*compare)(const void *, const void *))
+{
+    unsigned char *arr = (unsigned char *)array;
+    unsigned char *pivot;
+    int depth;
+
+    if (!array || size < 2 || nth >= size || !compare || !elem_size)
+        return;
+    if (!(pivot = malloc(elem_size)))
+        return;
+
+    depth = 2 * floor_log2(size);
+    while (size > SELECT_INSERTION_THRESHOLD)
+    {
+        size_t mid = size / 2;
+        size_t i, j;
+
+        if (depth-- == 0)
+        {
+            heap_select(arr, size, nth, elem_size, compare);
+            free(pivot);
+            return;
+        }
+
+        // Median of three ends up in the middle
+        if (compare(AT(arr, mid, elem_size), arr) < 0)
+            swap_bytes(AT(arr, mid, elem_size), arr, elem_size);
+        if (compare(AT(arr, size - 1, elem_size), AT(arr, mid, elem_size)) < 0)
+            swap_bytes(AT(arr, size - 1, elem_size), AT(arr, mid, elem_size), elem_size);
+        if (compare(AT(arr, mid, elem_size), arr) < 0)
+            swap_bytes(AT(arr, mid, elem_size), arr, elem_size);
+        memcpy(pivot, AT(arr, mid, elem_size), elem_size);
+
+        // Hoare partition: arr[0..j] <= pivot <= arr[j+1..size)
+        i = (size_t)-1;
+        j = size;
+        for (;;)
+        {
+            do
+                i++;
+            while (compare(AT(arr, i, elem_size), pivot) < 0);
+            do
+                j--;
+            while (compare(pivot, AT(arr, j, elem_size)) < 0);
+            if (i >= j)
+                break;
+            swap_bytes(AT(arr, i, elem_size), AT(arr, j, elem_size), elem_size);
+        }
+
+        // Keep only the side holding nth
+        if (nth <= j)
+            size = j + 1;
+        else
+        {
+            arr = AT(arr, j + 1, elem_size);
+            nth -= j + 1;
+            size -= j + 1;
+        }
+    }
+    insertion_range(arr, size, elem_size, compare);
+    free(pivot);
+}
+
+/**
+ * @brief Sorts the k smallest elements of an array into its first k slots
+ *
+ * Selects the k smallest elements with nth_element() in O(n), then sorts
+ * only those, for O(n + k log k) in total. The order of the remaining
+ * elements is unspecified.
+ *
+ * @param array Pointer to the array
+ * @param size Number of elements in the array
+ * @param k Number of leading elements to sort (clamped to size)
+ * @param elem_size Size of each element in bytes
+ * @param compare Comparison function to use
+ */
+void partial_sort(void *array, size_t size, size_t k, size_t elem_size,
+                  int (*compare)(const void *, const void *))
+{
+    if (!array || !compare || !elem_size || k == 0 || size < 2)
+        return;
+    if (k > size)
+        k = size;
+    if (k < size)
+        nth_element(array, size, k - 1, elem_size, compare);
+    if (!sort_typed(array, k, elem_size, compare))
+        heap_sort_range((unsigned char *)array, k, elem_size, compare, 1);
+}
+
+/**
+ * @brief Initialize a streaming top-k selector
+ *
+ * The selector keeps the k greatest elements pushed so far (according to
+ * compare) in a min-heap, so each push costs O(log k) at worst and O(1)
+ * when the element does not make it into the top k.
+ *
+ * @param topk Pointer to the selector to initialize
+ * @param k Number of elements to keep
+ * @param elem_size Size of each element in bytes
+ * @param compare Comparison function to use
+ * @return bool true on success, false on failure
+ */
+bool topk_init(TopK *topk, size_t k, size_t elem_size,
+               int (*compare)(const void *, const void *))
+{
+    if (!topk || !k || !elem_size || !compare)
+        return false;
+    topk->heap = malloc(k * elem_size);
+    if (!topk->heap)
+        return false;
+    topk->count = 0;
+    topk->capacity = k;
+    topk->elem_size = elem_size;
+    topk->compare = compare;
+    return true;
+}
+
+/**
+ * @brief Offer one element to the selector
+ *
+ * @param topk Pointer to the selector
+ * @param elem Pointer to the element (copied if kept)
+ * @return bool true if the element is now part of the top k
+ */
+bool topk_push(TopK *topk, const void *elem)
+{
+    size_t es;
+
+    if (!topk || !topk->heap || !elem)
+        return false;
+    es = topk->elem_size;
+
+    if (topk->count < topk->capacity)
+    {
+        memcpy(AT(topk->heap, topk->count, es), elem, es);
+        sift_up(topk->heap, topk->count++, es, topk->compare, -1);
+        return true;
+    }
+
+    // Smaller than or equal to the current k-th best: rejected in O(1)
+    if (topk->compare(elem, topk->heap) <= 0)
+        return false;
+    memcpy(topk->heap, elem, es);
+    sift_down(topk->heap, 0, topk->count, es, topk->compare, -1);
+    return true;
+}
+
+/**
+ * @brief Get the number of elements currently kept (at most k)
+ */
+size_t topk_size(const TopK *topk)
+{
+    return topk ? topk->count : 0;
+}
+
+/**
+ * @brief Copy the kept elements, greatest first
+ *
+ * @param topk Pointer to the selector
+ * @param out Destination array with room for topk_size() elements
+ * @return size_t Number of elements written
+ */
+size_t topk_sorted(const TopK *topk, void *out)
+{
+    if (!topk || !topk->heap || !out)
+        return 0;
+    memcpy(out, topk->heap, topk->count * topk->elem_size);
+    heap_sort_range((unsigned char *)out, topk->count, topk->elem_size, topk->compare, -1);
+    return topk->count;
+}
+
+/**
+ * @brief Drop all kept elements, keeping k and the comparator
+ */
+void topk_clear(TopK *topk)
+{
+    if (topk)
+        topk->count = 0;
+}
+
+/**
+ * @brief Destroy the selector and free its storage
+ */
+void topk_destroy(TopK *topk)
+{
+    if (!topk)
+        return;
+    free(topk->heap);
+    topk->heap = NULL;
+    topk->count = 0;
+    topk->capacity = 0;
+}
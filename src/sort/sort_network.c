@@ -0,0 +1,363 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   sort_network.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <lib/sort/sort.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define SORT_NETWORK_X86 1
+# include <immintrin.h>
+#endif
+
+/* Width of one network pass; larger inputs are sorted in blocks and merged */
+#define NETWORK_WIDTH 16
+
+/* At or below this size, insertion sort is faster than the network */
+#define NETWORK_MIN 8
+
+/* Flips the sign bit so unsigned keys order correctly as signed ones */
+#define BIAS32 ((uint32_t)1 << 31)
+#define BIAS64 ((uint64_t)1 << 63)
+
+/**
+ * @brief Portable bitonic network over 16 keys. Every compare-exchange is a
+ *        branchless min/max, the same pattern the vector kernels run.
+ */
+#define DEFINE_SCALAR_NETWORK(suffix, type)                                     \
+    static void bitonic16_##suffix##_scalar(type *v)                            \
+    {                                                                           \
+        for (size_t k = 2; k <= NETWORK_WIDTH; k <<= 1)                         \
+        {                                                                       \
+            for (size_t j = k >> 1; j > 0; j >>= 1)                             \
+            {                                                                   \
+                for (size_t i = 0; i < NETWORK_WIDTH; i++)                      \
+                {                                                               \
+                    size_t l = i ^ j;                                           \
+                    type lo, hi;                                                \
+                    if (l <= i)                                                 \
+                        continue;                                               \
+                    lo = (v[i] < v[l]) ? v[i] : v[l];                           \
+                    hi = (v[i] < v[l]) ? v[l] : v[i];                           \
+                    v[i] = (i & k) ? hi : lo;                                   \
+                    v[l] = (i & k) ? lo : hi;                                   \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+    }
+
+DEFINE_SCALAR_NETWORK(i32, int32_t)
+DEFINE_SCALAR_NETWORK(i64, int64_t)
+
+#ifdef SORT_NETWORK_X86
+
+/**
+ * @brief One in-register stage of the bitonic network: each lane meets the
+ *        lane at index ^ j and keeps the min or the max depending on its
+ *        position and the direction of its k-sized block.
+ */
+__attribute__((target("avx2")))
+static inline __m256i stage_i32(__m256i v, __m256i global, __m256i local, int j, int k)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i partner = _mm256_permutevar8x32_epi32(v, _mm256_xor_si256(local, _mm256_set1_epi32(j)));
+    __m256i lo = _mm256_min_epi32(v, partner);
+    __m256i hi = _mm256_max_epi32(v, partner);
+    __m256i lower = _mm256_cmpeq_epi32(_mm256_and_si256(global, _mm256_set1_epi32(j)), zero);
+    __m256i ascending = _mm256_cmpeq_epi32(_mm256_and_si256(global, _mm256_set1_epi32(k)), zero);
+
+    return _mm256_blendv_epi8(hi, lo, _mm256_cmpeq_epi32(lower, ascending));
+}
+
+/**
+ * @brief Bitonic network over 16 int32 held in two AVX2 registers
+ */
+__attribute__((target("avx2")))
+static void bitonic16_i32_avx2(int32_t *buf)
+{
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i lane_hi = _mm256_add_epi32(lane, _mm256_set1_epi32(8));
+    __m256i v0 = _mm256_loadu_si256((const __m256i *)buf);
+    __m256i v1 = _mm256_loadu_si256((const __m256i *)(buf + 8));
+
+    for (int k = 2; k <= NETWORK_WIDTH; k <<= 1)
+    {
+        for (int j = k >> 1; j > 0; j >>= 1)
+        {
+            if (j == 8)
+            {
+                // Only reached for k == 16, where every pair is ascending
+                __m256i lo = _mm256_min_epi32(v0, v1);
+                v1 = _mm256_max_epi32(v0, v1);
+                v0 = lo;
+                continue;
+            }
+            v0 = stage_i32(v0, lane, lane, j, k);
+            v1 = stage_i32(v1, lane_hi, lane, j, k);
+        }
+    }
+    _mm256_storeu_si256((__m256i *)buf, v0);
+    _mm256_storeu_si256((__m256i *)(buf + 8), v1);
+}
+
+__attribute__((target("avx2")))
+static inline void minmax_i64(__m256i a, __m256i b, __m256i *lo, __m256i *hi)
+{
+    __m256i gt = _mm256_cmpgt_epi64(a, b);
+
+    *lo = _mm256_blendv_epi8(a, b, gt);
+    *hi = _mm256_blendv_epi8(b, a, gt);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i stage_i64(__m256i v, __m256i global, int j, int k)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i partner = (j == 1) ? _mm256_permute4x64_epi64(v, 0xB1)
+                               : _mm256_permute4x64_epi64(v, 0x4E);
+    __m256i lo, hi;
+    __m256i lower = _mm256_cmpeq_epi64(_mm256_and_si256(global, _mm256_set1_epi64x(j)), zero);
+    __m256i ascending = _mm256_cmpeq_epi64(_mm256_and_si256(global, _mm256_set1_epi64x(k)), zero);
+
+    minmax_i64(v, partner, &lo, &hi);
+    return _mm256_blendv_epi8(hi, lo, _mm256_cmpeq_epi64(lower, ascending));
+}
+
+/**
+ * @brief Bitonic network over 16 int64 held in four AVX2 registers. AVX2
+ *        has no 64-bit min/max, so they are built from cmpgt + blend.
+ */
+__attribute__((target("avx2")))
+static void bitonic16_i64_avx2(int64_t *buf)
+{
+    __m256i v[4], index[4];
+
+    for (int r = 0; r < 4; r++)
+    {
+        v[r] = _mm256_loadu_si256((const __m256i *)(buf + 4 * r));
+        index[r] = _mm256_setr_epi64x(4 * r, 4 * r + 1, 4 * r + 2, 4 * r + 3);
+    }
+
+    for (int k = 2; k <= NETWORK_WIDTH; k <<= 1)
+    {
+        for (int j = k >> 1; j > 0; j >>= 1)
+        {
+            if (j < 4)
+            {
+                for (int r = 0; r < 4; r++)
+                    v[r] = stage_i64(v[r], index[r], j, k);
+                continue;
+            }
+            // Partner lanes live in another register, same lane position
+            for (int r = 0; r < 4; r++)
+            {
+                int p = r ^ (j / 4);
+                __m256i lo, hi;
+                if (p < r)
+                    continue;
+                minmax_i64(v[r], v[p], &lo, &hi);
+                v[r] = ((4 * r) & k) ? hi : lo;
+                v[p] = ((4 * r) & k) ? lo : hi;
+            }
+        }
+    }
+    for (int r = 0; r < 4; r++)
+        _mm256_storeu_si256((__m256i *)(buf + 4 * r), v[r]);
+}
+
+static int has_avx2(void)
+{
+    static int cached = -1;
+
+    if (cached < 0)
+    {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached;
+}
+
+#endif /* SORT_NETWORK_X86 */
+
+static void bitonic16_i32(int32_t *buf)
+{
+#ifdef SORT_NETWORK_X86
+    if (has_avx2())
+    {
+        bitonic16_i32_avx2(buf);
+        return;
+    }
+#endif
+    bitonic16_i32_scalar(buf);
+}
+
+static void bitonic16_i64(int64_t *buf)
+{
+#ifdef SORT_NETWORK_X86
+    if (has_avx2())
+    {
+        bitonic16_i64_avx2(buf);
+        return;
+    }
+#endif
+    bitonic16_i64_scalar(buf);
+}
+
+/**
+ * @brief Sorts up to 64 keys: each 16-key block goes through the network
+ *        (padded with the maximum key), then blocks are merged pairwise
+ *        through a stack buffer. The bias is applied on the way in and
+ *        removed on the way out, so unsigned keys reuse the signed network.
+ */
+#define DEFINE_SMALL_SORT(suffix, type, stype, utype, MAXV, BIAS, NETWORK)     \
+    static void small_sort_##suffix(type *array, size_t size)                  \
+    {                                                                           \
+        stype buf[SORT_NETWORK_MAX];                                            \
+        stype tmp[SORT_NETWORK_MAX];                                            \
+        stype *src = buf, *dst = tmp, *swap;                                    \
+                                                                                \
+        /* Padding a whole network costs more than it saves on tiny inputs */ \
+        if (size <= NETWORK_MIN)                                                \
+        {                                                                       \
+            for (size_t i = 1; i < size; i++)                                   \
+            {                                                                   \
+                type x = array[i];                                              \
+                size_t j = i;                                                   \
+                while (j > 0 && x < array[j - 1])                               \
+                {                                                               \
+                    array[j] = array[j - 1];                                    \
+                    j--;                                                        \
+                }                                                               \
+                array[j] = x;                                                   \
+            }                                                                   \
+            return;                                                             \
+        }                                                                       \
+        for (size_t i = 0; i < size; i++)                                       \
+            buf[i] = (stype)((utype)array[i] ^ (BIAS));                        \
+        for (size_t start = 0; start < size; start += NETWORK_WIDTH)            \
+        {                                                                       \
+            stype block[NETWORK_WIDTH];                                         \
+            size_t n = size - start;                                            \
+            if (n > NETWORK_WIDTH)                                              \
+                n = NETWORK_WIDTH;                                              \
+            memcpy(block, buf + start, n * sizeof(stype));                     \
+            for (size_t i = n; i < NETWORK_WIDTH; i++)                          \
+                block[i] = MAXV;                                                \
+            NETWORK(block);                                                     \
+            memcpy(buf + start, block, n * sizeof(stype));                     \
+        }                                                                       \
+        for (size_t width = NETWORK_WIDTH; width < size; width *= 2)            \
+        {                                                                       \
+            for (size_t lo = 0; lo < size; lo += 2 * width)                     \
+            {                                                                   \
+                size_t mid = (lo + width < size) ? lo + width : size;           \
+                size_t hi = (lo + 2 * width < size) ? lo + 2 * width : size;    \
+                size_t i = lo, j = mid, k = lo;                                 \
+                while (i < mid && j < hi)                                       \
+                {                                                               \
+                    int take_right = src[j] < src[i];                           \
+                    dst[k++] = take_right ? src[j] : src[i];                    \
+                    j += take_right;                                            \
+                    i += !take_right;                                           \
+                }                                                               \
+                while (i < mid)                                                 \
+                    dst[k++] = src[i++];                                        \
+                while (j < hi)                                                  \
+                    dst[k++] = src[j++];                                        \
+            }                                                                   \
+            swap = src;                                                         \
+            src = dst;                                                          \
+            dst = swap;                                                         \
+        }                                                                       \
+        for (size_t i = 0; i < size; i++)                                       \
+            array[i] = (type)((utype)src[i] ^ (BIAS));                          \
+    }
+
+DEFINE_SMALL_SORT(i32, int32_t, int32_t, uint32_t, INT32_MAX, 0, bitonic16_i32)
+DEFINE_SMALL_SORT(u32, uint32_t, int32_t, uint32_t, INT32_MAX, BIAS32, bitonic16_i32)
+DEFINE_SMALL_SORT(i64, int64_t, int64_t, uint64_t, INT64_MAX, 0, bitonic16_i64)
+DEFINE_SMALL_SORT(u64, uint64_t, int64_t, uint64_t, INT64_MAX, BIAS64, bitonic16_i64)
+
+/**
+ * @brief Sorts a small array of 32-bit signed keys with a sorting network
+ *
+ * Uses AVX2 when the CPU supports it, a branchless scalar network
+ * otherwise. Arrays longer than SORT_NETWORK_MAX go to the typed introsort.
+ *
+ * @param array Pointer to the array to be sorted
+ * @param size Number of elements in the array
+ */
+void sort_network_i32(int32_t *array, size_t size)
+{
+    if (!array || size < 2)
+        return;
+    if (size > SORT_NETWORK_MAX)
+    {
+        sort_int((int *)array, size);
+        return;
+    }
+    small_sort_i32(array, size);
+}
+
+/**
+ * @brief Sorts a small array of 32-bit unsigned keys with a sorting network
+ *
+ * @param array Pointer to the array to be sorted
+ * @param size Number of elements in the array
+ */
+void sort_network_u32(uint32_t *array, size_t size)
+{
+    if (!array || size < 2)
+        return;
+    if (size > SORT_NETWORK_MAX)
+    {
+        sort_uint((unsigned int *)array, size);
+        return;
+    }
+    small_sort_u32(array, size);
+}
+
+/**
+ * @brief Sorts a small array of 64-bit signed keys with a sorting network
+ *
+ * @param array Pointer to the array to be sorted
+ * @param size Number of elements in the array
+ */
+void sort_network_i64(int64_t *array, size_t size)
+{
+    if (!array || size < 2)
+        return;
+    if (size > SORT_NETWORK_MAX)
+    {
+        sort_i64(array, size);
+        return;
+    }
+    small_sort_i64(array, size);
+}
+
+/**
+ * @brief Sorts a small array of 64-bit unsigned keys with a sorting network
+ *
+ * @param array Pointer to the array to be sorted
+ * @param size Number of elements in the array
+ */
+void sort_network_u64(uint64_t *array, size_t size)
+{
+    if (!array || size < 2)
+        return;
+    if (size > SORT_NETWORK_MAX)
+    {
+        sort_u64(array, size);
+        return;
+    }
+    small_sort_u64(array, size);
+}
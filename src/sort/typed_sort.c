@@ -0,0 +1,311 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   typed_sort.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <lib/algorithms/compare.h>
+#include <lib/sort/sort.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Partitions shorter than this are finished by the base case sort */
+#define TYPED_INSERTION_THRESHOLD 16
+
+#define LESS_SCALAR(a, b) ((a) < (b))
+
+/* Ties broken on the original index, which makes sort_by_key stable */
+#define LESS_KEYED(a, b) ((a).key < (b).key || ((a).key == (b).key && (a).index < (b).index))
+
+typedef struct KeyedIndex
+{
+    uint64_t key;
+    size_t index;
+} KeyedIndex;
+
+static int floor_log2(size_t n)
+{
+    int log = 0;
+
+    while (n >>= 1)
+        log++;
+    return log;
+}
+
+/*
+ * Base cases for integer kernels: the sorting networks, which sort the
+ * array in place. They are picked by pointer type, without a cast, only
+ * when the element type is the fixed-width type itself (int is int32_t,
+ * long is int64_t on LP64); otherwise insertion sort is used.
+ */
+#define BASE_insertion(suffix, a, n) insertion_##suffix(a, n)
+#define BASE_network_signed(suffix, a, n)                                       \
+    _Generic((a), int32_t *: sort_network_i32, int64_t *: sort_network_i64,    \
+             default: insertion_##suffix)(a, n)
+#define BASE_network_unsigned(suffix, a, n)                                     \
+    _Generic((a), uint32_t *: sort_network_u32, uint64_t *: sort_network_u64,  \
+             default: insertion_##suffix)(a, n)
+
+/**
+ * @brief Generates an introsort (median-of-3 quicksort, heapsort past the
+ *        depth limit, BASE for short ranges) for one element type.
+ *        Comparisons and moves are plain expressions on `type`, so the
+ *        compiler inlines them instead of calling through a pointer.
+ */
+#define DEFINE_TYPED_SORT(suffix, type, LESS, BASE)                             \
+    [[maybe_unused]] static void insertion_##suffix(type *a, size_t n)          \
+    {                                                                           \
+        for (size_t i = 1; i < n; i++)                                          \
+        {                                                                       \
+            type x = a[i];                                                      \
+            size_t j = i;                                                       \
+            while (j > 0 && LESS(x, a[j - 1]))                                  \
+            {                                                                   \
+                a[j] = a[j - 1];                                                \
+                j--;                                                            \
+            }                                                                   \
+            a[j] = x;                                                           \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    static void sift_down_##suffix(type *a, size_t root, size_t n)              \
+    {                                                                           \
+        type x = a[root];                                                       \
+        size_t child;                                                           \
+                                                                                \
+        while ((child = 2 * root + 1) < n)                                      \
+        {                                                                       \
+            if (child + 1 < n && LESS(a[child], a[child + 1]))                  \
+                child++;                                                        \
+            if (!LESS(x, a[child]))                                             \
+                break;                                                          \
+            a[root] = a[child];                                                 \
+            root = child;                                                       \
+        }                                                                       \
+        a[root] = x;                                                            \
+    }                                                                           \
+                                                                                \
+    static void heapsort_##suffix(type *a, size_t n)                            \
+    {                                                                           \
+        for (size_t i = n / 2; i-- > 0;)                                        \
+            sift_down_##suffix(a, i, n);                                        \
+        while (n > 1)                                                           \
+        {                                                                       \
+            type top = a[0];                                                    \
+            a[0] = a[--n];                                                      \
+            a[n] = top;                                                         \
+            sift_down_##suffix(a, 0, n);                                        \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    static void introsort_##suffix(type *a, size_t n, int depth)                \
+    {                                                                           \
+        while (n > TYPED_INSERTION_THRESHOLD)                                   \
+        {                                                                       \
+            size_t mid = n / 2, i, j;                                           \
+            type pivot, tmp;                                                    \
+                                                                                \
+            if (depth-- == 0)                                                   \
+            {                                                                   \
+                heapsort_##suffix(a, n);                                        \
+                return;                                                         \
+            }                                                                   \
+                                                                                \
+            /* Median of three ends up in a[mid] */                             \
+            if (LESS(a[mid], a[0]))                                             \
+                tmp = a[mid], a[mid] = a[0], a[0] = tmp;                        \
+            if (LESS(a[n - 1], a[mid]))                                         \
+                tmp = a[n - 1], a[n - 1] = a[mid], a[mid] = tmp;                \
+            if (LESS(a[mid], a[0]))                                             \
+                tmp = a[mid], a[mid] = a[0], a[0] = tmp;                        \
+            pivot = a[mid];                                                     \
+                                                                                \
+            /* Hoare partition: a[0..j] <= pivot <= a[j+1..n) */                \
+            i = (size_t)-1;                                                     \
+            j = n;                                                              \
+            for (;;)                                                            \
+            {                                                                   \
+                do                                                              \
+                    i++;                                                        \
+                while (LESS(a[i], pivot));                                      \
+                do                                                              \
+                    j--;                                                        \
+                while (LESS(pivot, a[j]));                                      \
+                if (i >= j)                                                     \
+                    break;                                                      \
+                tmp = a[i], a[i] = a[j], a[j] = tmp;                            \
+            }                                                                   \
+                                                                                \
+            /* Recurse into the smaller side, loop on the larger one */         \
+            if (j + 1 < n - j - 1)                                              \
+            {                                                                   \
+                introsort_##suffix(a, j + 1, depth);                            \
+                a += j + 1;                                                     \
+                n -= j + 1;                                                     \
+            }                                                                   \
+            else                                                                \
+            {                                                                   \
+                introsort_##suffix(a + j + 1, n - j - 1, depth);                \
+                n = j + 1;                                                      \
+            }                                                                   \
+        }                                                                       \
+        BASE_##BASE(suffix, a, n);                                              \
+    }                                                                           \
+                                                                                \
+    static void typed_sort_##suffix(type *a, size_t n)                          \
+    {                                                                           \
+        if (!a || n < 2)                                                        \
+            return;                                                             \
+        introsort_##suffix(a, n, 2 * floor_log2(n));                            \
+    }
+
+DEFINE_TYPED_SORT(char, char, LESS_SCALAR, insertion)
+DEFINE_TYPED_SORT(uchar, unsigned char, LESS_SCALAR, insertion)
+DEFINE_TYPED_SORT(short, short, LESS_SCALAR, insertion)
+DEFINE_TYPED_SORT(ushort, unsigned short, LESS_SCALAR, insertion)
+DEFINE_TYPED_SORT(int, int, LESS_SCALAR, network_signed)
+DEFINE_TYPED_SORT(uint, unsigned int, LESS_SCALAR, network_unsigned)
+DEFINE_TYPED_SORT(long, long, LESS_SCALAR, network_signed)
+DEFINE_TYPED_SORT(ulong, unsigned long, LESS_SCALAR, network_unsigned)
+DEFINE_TYPED_SORT(i64, int64_t, LESS_SCALAR, network_signed)
+DEFINE_TYPED_SORT(u64, uint64_t, LESS_SCALAR, network_unsigned)
+DEFINE_TYPED_SORT(float, float, LESS_SCALAR, insertion)
+DEFINE_TYPED_SORT(double, double, LESS_SCALAR, insertion)
+DEFINE_TYPED_SORT(keyed, KeyedIndex, LESS_KEYED, insertion)
+
+void sort_int(int *array, size_t size)
+{
+    typed_sort_int(array, size);
+}
+
+void sort_uint(unsigned int *array, size_t size)
+{
+    typed_sort_uint(array, size);
+}
+
+void sort_long(long *array, size_t size)
+{
+    typed_sort_long(array, size);
+}
+
+void sort_ulong(unsigned long *array, size_t size)
+{
+    typed_sort_ulong(array, size);
+}
+
+void sort_i64(int64_t *array, size_t size)
+{
+    typed_sort_i64(array, size);
+}
+
+void sort_u64(uint64_t *array, size_t size)
+{
+    typed_sort_u64(array, size);
+}
+
+void sort_float(float *array, size_t size)
+{
+    typed_sort_float(array, size);
+}
+
+void sort_double(double *array, size_t size)
+{
+    typed_sort_double(array, size);
+}
+
+/**
+ * @brief Sorts records by a 64-bit key without calling a comparator
+ *
+ * Keys are extracted once into (key, index) pairs, the pairs are sorted
+ * with an inlined comparison, then the records are permuted into place.
+ * Equal keys keep their original order.
+ *
+ * @param array Pointer to the array to be sorted
+ * @param size Number of elements in the array
+ * @param elem_size Size of each element in bytes
+ * @param key Function returning the sort key of an element
+ *
+ * @note Needs size * (elem_size + 16) bytes of scratch memory. Does nothing
+ *       if it cannot be allocated.
+ */
+void sort_by_key(void *array, size_t size, size_t elem_size,
+                 uint64_t (*key)(const void *))
+{
+    unsigned char *arr = (unsigned char *)array;
+    unsigned char *sorted;
+    KeyedIndex *keys;
+
+    if (!array || size < 2 || !elem_size || !key)
+        return;
+
+    keys = malloc(size * sizeof(KeyedIndex));
+    sorted = malloc(size * elem_size);
+    if (!keys || !sorted)
+    {
+        free(keys);
+        free(sorted);
+        return;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        keys[i].key = key(arr + i * elem_size);
+        keys[i].index = i;
+    }
+    typed_sort_keyed(keys, size);
+
+    for (size_t i = 0; i < size; i++)
+        memcpy(sorted + i * elem_size, arr + keys[i].index * elem_size, elem_size);
+    memcpy(arr, sorted, size * elem_size);
+
+    free(keys);
+    free(sorted);
+}
+
+#define DISPATCH(func, type, suffix)                                           \
+    if (compare == func && elem_size == sizeof(type))                           \
+    {                                                                           \
+        typed_sort_##suffix((type *)array, size);                               \
+        return true;                                                            \
+    }
+
+/**
+ * @brief Sorts with a specialised kernel when the comparator is known
+ *
+ * Recognises the scalar compare_* functions from compare.h and runs the
+ * matching inlined sort instead of calling the comparator per element.
+ *
+ * @param array Pointer to the array to be sorted
+ * @param size Number of elements in the array
+ * @param elem_size Size of each element in bytes
+ * @param compare Comparison function the caller would have used
+ * @return bool true if the array was sorted, false if compare is not a
+ *         known scalar comparator (the array is left untouched)
+ *
+ * @note The kernels are not stable. For integers this is unobservable; for
+ *       floating point, +0.0 and -0.0 compare equal and may swap places.
+ */
+bool sort_typed(void *array, size_t size, size_t elem_size,
+                int (*compare)(const void *, const void *))
+{
+    if (!array || !compare)
+        return false;
+
+    DISPATCH(compare_char, char, char)
+    DISPATCH(compare_uchar, unsigned char, uchar)
+    DISPATCH(compare_short, short, short)
+    DISPATCH(compare_ushort, unsigned short, ushort)
+    DISPATCH(compare_int, int, int)
+    DISPATCH(compare_uint, unsigned int, uint)
+    DISPATCH(compare_long, long, long)
+    DISPATCH(compare_ulong, unsigned long, ulong)
+    DISPATCH(compare_float, float, float)
+    DISPATCH(compare_double, double, double)
+    return false;
+}
@@ -0,0 +1,229 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   aho_corasick.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../includes/lib/strings/aho_corasick.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Transitions hold the target's row offset (state * classes), so a scan
+ * never multiplies, and the high bit flags targets that report a match.
+ */
+#define AC_MATCH 0x80000000u
+
+static size_t pattern_len(const char *const *patterns, const size_t *lengths, size_t i) {
+	if (!patterns[i])
+		return 0;
+	return lengths ? lengths[i] : strlen(patterns[i]);
+}
+
+static void build_classes(AhoCorasick *ac, const char *const *patterns, const size_t *lengths, size_t count) {
+	bool used[256] = {false};
+
+	for (size_t i = 0; i < count; i++) {
+		const unsigned char *p = (const unsigned char *)patterns[i];
+		for (size_t j = 0, len = pattern_len(patterns, lengths, i); j < len; j++)
+			used[p[j]] = true;
+	}
+	// Class 0 gathers every byte no pattern contains
+	ac->num_classes = 1;
+	for (size_t b = 0; b < 256; b++)
+		ac->byte_class[b] = used[b] ? (uint8_t)ac->num_classes++ : 0;
+}
+
+static void build_trie(AhoCorasick *ac, const char *const *patterns, size_t count) {
+	size_t nc = ac->num_classes;
+
+	ac->num_states = 1;
+	// Inserted backwards so duplicate chains list lower indexes first
+	for (size_t i = count; i-- > 0;) {
+		const unsigned char *p = (const unsigned char *)patterns[i];
+		size_t row			   = 0;
+		if (ac->lengths[i] == 0)
+			continue;
+		for (size_t j = 0; j < ac->lengths[i]; j++) {
+			uint32_t *slot = &ac->delta[row + ac->byte_class[p[j]]];
+			if (!*slot)
+				*slot = (uint32_t)(ac->num_states++ * nc);
+			row = *slot;
+		}
+		ac->next_output[i]	   = ac->output[row / nc];
+		ac->output[row / nc] = (uint32_t)i;
+	}
+}
+
+/*
+ * Renumber states in breadth-first order. Scans spend nearly all their
+ * time in shallow states; packing them together keeps the hot rows in
+ * cache instead of scattered along the order the patterns were inserted.
+ */
+static bool renumber(AhoCorasick *ac, uint32_t *order) {
+	size_t nc		  = ac->num_classes;
+	size_t n		  = ac->num_states;
+	uint32_t *new_id  = malloc(n * sizeof(uint32_t));
+	uint32_t *delta	  = malloc(n * nc * sizeof(uint32_t));
+	uint32_t *output  = malloc(n * sizeof(uint32_t));
+	uint32_t *dict	  = malloc(n * sizeof(uint32_t));
+
+	if (!new_id || !delta || !output || !dict) {
+		free(new_id);
+		free(delta);
+		free(output);
+		free(dict);
+		free(order);
+		return false;
+	}
+	for (size_t i = 0; i < n; i++)
+		new_id[order[i]] = (uint32_t)i;
+	for (size_t i = 0; i < n; i++) {
+		const uint32_t *row = &ac->delta[order[i] * nc];
+		for (size_t c = 0; c < nc; c++)
+			delta[i * nc + c] = (uint32_t)(new_id[(row[c] & ~AC_MATCH) / nc] * nc) | (row[c] & AC_MATCH);
+		output[i] = ac->output[order[i]];
+		dict[i]	  = (ac->dict_link[order[i]] == AC_NONE) ? AC_NONE : new_id[ac->dict_link[order[i]]];
+	}
+	free(new_id);
+	free(order);
+	free(ac->delta);
+	free(ac->output);
+	free(ac->dict_link);
+	ac->delta	  = delta;
+	ac->output	  = output;
+	ac->dict_link = dict;
+	return true;
+}
+
+/* Breadth-first pass: failure links, dictionary links, missing transitions */
+static bool build_links(AhoCorasick *ac) {
+	size_t nc		= ac->num_classes;
+	uint32_t *fail	= malloc(ac->num_states * sizeof(uint32_t));
+	uint32_t *queue = malloc(ac->num_states * sizeof(uint32_t));
+	size_t head = 0, tail = 0;
+
+	if (!fail || !queue) {
+		free(fail);
+		free(queue);
+		return false;
+	}
+	fail[0]	 = 0;
+	queue[tail++] = 0;
+	while (head < tail) {
+		uint32_t state = queue[head++];
+		uint32_t *row  = &ac->delta[state * nc];
+		uint32_t *back = &ac->delta[fail[state] * nc];
+		for (size_t c = 0; c < nc; c++) {
+			if (row[c]) {
+				uint32_t child = row[c] / nc;
+				uint32_t link  = state ? back[c] / nc : 0;
+				fail[child]	   = link;
+				ac->dict_link[child] = (ac->output[link] != AC_NONE) ? link : ac->dict_link[link];
+				queue[tail++]		 = child;
+			} else if (state)
+				row[c] = back[c];
+		}
+	}
+	free(fail);
+
+	for (size_t i = 0; i < ac->num_states * nc; i++) {
+		uint32_t target = ac->delta[i] / nc;
+		if (ac->output[target] != AC_NONE || ac->dict_link[target] != AC_NONE)
+			ac->delta[i] |= AC_MATCH;
+	}
+	return renumber(ac, queue);
+}
+
+bool aho_corasick_init(AhoCorasick *ac, const char *const *patterns, const size_t *lengths, size_t count) {
+	size_t total = 1;
+
+	if (!ac || (!patterns && count))
+		return false;
+	memset(ac, 0, sizeof(*ac));
+	build_classes(ac, patterns, lengths, count);
+	for (size_t i = 0; i < count; i++)
+		total += pattern_len(patterns, lengths, i);
+	// Every row offset must fit below the match flag
+	if (total > (AC_MATCH - 1) / ac->num_classes)
+		return false;
+
+	ac->num_patterns = count;
+	ac->delta		 = calloc(total * ac->num_classes, sizeof(uint32_t));
+	ac->output		 = malloc(total * sizeof(uint32_t));
+	ac->dict_link	 = malloc(total * sizeof(uint32_t));
+	ac->next_output	 = malloc((count ? count : 1) * sizeof(uint32_t));
+	ac->lengths		 = malloc((count ? count : 1) * sizeof(size_t));
+	if (!ac->delta || !ac->output || !ac->dict_link || !ac->next_output || !ac->lengths) {
+		aho_corasick_destroy(ac);
+		return false;
+	}
+	for (size_t i = 0; i < total; i++)
+		ac->output[i] = ac->dict_link[i] = AC_NONE;
+	for (size_t i = 0; i < count; i++)
+		ac->lengths[i] = pattern_len(patterns, lengths, i);
+
+	build_trie(ac, patterns, count);
+	if (!build_links(ac)) {
+		aho_corasick_destroy(ac);
+		return false;
+	}
+	return true;
+}
+
+void aho_corasick_destroy(AhoCorasick *ac) {
+	if (!ac)
+		return;
+	free(ac->delta);
+	free(ac->output);
+	free(ac->dict_link);
+	free(ac->next_output);
+	free(ac->lengths);
+	memset(ac, 0, sizeof(*ac));
+}
+
+size_t aho_corasick_scan(const AhoCorasick *ac, const char *text, size_t len, AhoCorasickMatchFn on_match,
+						 void *ctx) {
+	const unsigned char *t = (const unsigned char *)text;
+	size_t nc			   = ac->num_classes;
+	size_t matches		   = 0;
+	uint32_t row		   = 0;
+
+	if (!ac->delta || !text)
+		return 0;
+	for (size_t i = 0; i < len; i++) {
+		uint32_t next = ac->delta[row + ac->byte_class[t[i]]];
+		row			  = next & ~AC_MATCH;
+		if (!(next & AC_MATCH))
+			continue;
+		for (uint32_t state = row / nc; state != AC_NONE; state = ac->dict_link[state]) {
+			for (uint32_t p = ac->output[state]; p != AC_NONE; p = ac->next_output[p]) {
+				matches++;
+				if (on_match && !on_match(p, i + 1 - ac->lengths[p], i + 1, ctx))
+					return matches;
+			}
+		}
+	}
+	return matches;
+}
+
+bool aho_corasick_contains(const AhoCorasick *ac, const char *text, size_t len) {
+	const unsigned char *t = (const unsigned char *)text;
+	uint32_t row		   = 0;
+
+	if (!ac->delta || !text)
+		return false;
+	for (size_t i = 0; i < len; i++) {
+		uint32_t next = ac->delta[row + ac->byte_class[t[i]]];
+		if (next & AC_MATCH)
+			return true;
+		row = next;
+	}
+	return false;
+}
@@ -0,0 +1,364 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   number_format.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../includes/lib/strings/strings.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Number formatting into caller buffers. Integers are written two digits
+ * per step from a lookup table; doubles use Grisu2, which always yields
+ * a string that parses back to the same double and is the shortest such
+ * string for the overwhelming majority of inputs.
+ */
+
+#define CACHED_POWERS 87
+#define DP_SIGNIFICAND_BITS 52
+#define DP_HIDDEN_BIT (1ULL << DP_SIGNIFICAND_BITS)
+#define DP_EXPONENT_BIAS 1075
+
+typedef struct DiyFp {
+	uint64_t f;
+	int e;
+} DiyFp;
+
+static const char digit_pairs[201] = "00010203040506070809"
+									 "10111213141516171819"
+									 "20212223242526272829"
+									 "30313233343536373839"
+									 "40414243444546474849"
+									 "50515253545556575859"
+									 "60616263646566676869"
+									 "70717273747576777879"
+									 "80818283848586878889"
+									 "90919293949596979899";
+
+static const uint64_t pow10_u64[20] = {
+	1ULL,
+	10ULL,
+	100ULL,
+	1000ULL,
+	10000ULL,
+	100000ULL,
+	1000000ULL,
+	10000000ULL,
+	100000000ULL,
+	1000000000ULL,
+	10000000000ULL,
+	100000000000ULL,
+	1000000000000ULL,
+	10000000000000ULL,
+	100000000000000ULL,
+	1000000000000000ULL,
+	10000000000000000ULL,
+	100000000000000000ULL,
+	1000000000000000000ULL,
+	10000000000000000000ULL,
+};
+
+/* Normalised 64-bit approximations of 10^k, k = -348 + 8i */
+static const uint64_t cached_powers_f[CACHED_POWERS];
+static const int16_t cached_powers_e[CACHED_POWERS];
+
+/* Integers */
+static unsigned count_digits(uint64_t v) {
+	// log10 estimated from log2 (1233 / 4096 ~ log10(2)), then corrected
+	unsigned t = ((64 - __builtin_clzll(v | 1)) * 1233) >> 12;
+	unsigned n = t + (v >= pow10_u64[t]);
+
+	return n ? n : 1;
+}
+
+/* Writes the digits of v so that they end just before end */
+static void write_digits(char *end, uint64_t v) {
+	while (v >= 100) {
+		unsigned pair = (unsigned)(v % 100) * 2;
+		v /= 100;
+		end -= 2;
+		memcpy(end, digit_pairs + pair, 2);
+	}
+	if (v >= 10) {
+		end -= 2;
+		memcpy(end, digit_pairs + v * 2, 2);
+	} else
+		*--end = (char)('0' + v);
+}
+
+size_t str_format_u64(char *buf, uint64_t value) {
+	unsigned len = count_digits(value);
+
+	write_digits(buf + len, value);
+	buf[len] = '\0';
+	return len;
+}
+
+size_t str_format_i64(char *buf, int64_t value) {
+	// Negate in unsigned arithmetic so INT64_MIN does not overflow
+	if (value < 0) {
+		*buf = '-';
+		return 1 + str_format_u64(buf + 1, 0 - (uint64_t)value);
+	}
+	return str_format_u64(buf, (uint64_t)value);
+}
+
+size_t str_format_long(char *buf, long value) {
+	return str_format_i64(buf, value);
+}
+
+size_t str_format_int(char *buf, int value) {
+	return str_format_i64(buf, value);
+}
+
+/* Grisu2 (Loitsch), after the formulation in Milo Yip's dtoa */
+static DiyFp diy_from_double(double d) {
+	uint64_t bits;
+	int biased_e;
+	uint64_t significand;
+
+	memcpy(&bits, &d, sizeof(bits));
+	biased_e	= (int)((bits >> DP_SIGNIFICAND_BITS) & 0x7FF);
+	significand = bits & (DP_HIDDEN_BIT - 1);
+	if (biased_e)
+		return (DiyFp){significand + DP_HIDDEN_BIT, biased_e - DP_EXPONENT_BIAS};
+	return (DiyFp){significand, 1 - DP_EXPONENT_BIAS};
+}
+
+static DiyFp diy_multiply(DiyFp a, DiyFp b) {
+	unsigned __int128 p = (unsigned __int128)a.f * b.f;
+	uint64_t high		= (uint64_t)(p >> 64);
+
+	// Round the dropped half
+	high += ((uint64_t)p >> 63);
+	return (DiyFp){high, a.e + b.e + 64};
+}
+
+static DiyFp diy_normalize(DiyFp v) {
+	int shift = __builtin_clzll(v.f);
+
+	return (DiyFp){v.f << shift, v.e - shift};
+}
+
+/* Boundaries m- and m+ of the rounding interval, sharing m+'s exponent */
+static void normalized_boundaries(DiyFp v, DiyFp *minus, DiyFp *plus) {
+	DiyFp pl = diy_normalize((DiyFp){(v.f << 1) + 1, v.e - 1});
+	DiyFp mi;
+
+	// The gap below a power of two is half the gap above it
+	if (v.f == DP_HIDDEN_BIT)
+		mi = (DiyFp){(v.f << 2) - 1, v.e - 2};
+	else
+		mi = (DiyFp){(v.f << 1) - 1, v.e - 1};
+	mi.f <<= mi.e - pl.e;
+	mi.e   = pl.e;
+	*minus = mi;
+	*plus  = pl;
+}
+
+static DiyFp cached_power(int e, int *k) {
+	// Power c_k such that the product's exponent lands in [-60, -32]
+	double dk	   = (-61 - e) * 0.30102999566398114 + 347;
+	int ki		   = (int)dk;
+	unsigned index;
+
+	if (dk - ki > 0.0)
+		ki++;
+	index = (unsigned)((ki >> 3) + 1);
+	*k	  = -(-348 + (int)(index << 3));
+	return (DiyFp){cached_powers_f[index], cached_powers_e[index]};
+}
+
+static void grisu_round(char *buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+	// Walk the last digit down while that moves closer to the exact value
+	while (rest < wp_w && delta - rest >= ten_kappa &&
+		   (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+		buffer[len - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+static void digit_gen(DiyFp w, DiyFp mp, uint64_t delta, char *buffer, int *len, int *k) {
+	const DiyFp one		= {1ULL << -mp.e, mp.e};
+	const uint64_t wp_w = mp.f - w.f;
+	uint32_t p1			= (uint32_t)(mp.f >> -one.e);
+	uint64_t p2			= mp.f & (one.f - 1);
+	int kappa			= (int)count_digits(p1);
+
+	*len = 0;
+	while (kappa > 0) {
+		uint32_t d = (uint32_t)(p1 / pow10_u64[kappa - 1]);
+		p1		   = (uint32_t)(p1 % pow10_u64[kappa - 1]);
+		if (d || *len)
+			buffer[(*len)++] = (char)('0' + d);
+		kappa--;
+		uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+		if (rest <= delta) {
+			*k += kappa;
+			grisu_round(buffer, *len, delta, rest, pow10_u64[kappa] << -one.e, wp_w);
+			return;
+		}
+	}
+	for (;;) {
+		p2 *= 10;
+		delta *= 10;
+		char d = (char)(p2 >> -one.e);
+		if (d || *len)
+			buffer[(*len)++] = (char)('0' + d);
+		p2 &= one.f - 1;
+		kappa--;
+		if (p2 < delta) {
+			*k += kappa;
+			grisu_round(buffer, *len, delta, p2, one.f, wp_w * (-kappa < 20 ? pow10_u64[-kappa] : 0));
+			return;
+		}
+	}
+}
+
+/* Round-trip digits of a positive finite double: value = digits * 10^k */
+static int grisu2(double value, char *digits, int *k) {
+	DiyFp v = diy_from_double(value);
+	DiyFp minus, plus, c, w, wp, wm;
+	int len;
+
+	normalized_boundaries(v, &minus, &plus);
+	c  = cached_power(plus.e, k);
+	w  = diy_multiply(diy_normalize(v), c);
+	wp = diy_multiply(plus, c);
+	wm = diy_multiply(minus, c);
+	// Stay strictly inside the interval despite the rounded products
+	wm.f++;
+	wp.f--;
+	digit_gen(w, wp, wp.f - wm.f, digits, &len, k);
+	return len;
+}
+
+static int write_exponent(char *buf, int exp) {
+	char *p = buf;
+
+	if (exp < 0) {
+		*p++ = '-';
+		exp	 = -exp;
+	}
+	if (exp >= 100) {
+		*p++ = (char)('0' + exp / 100);
+		exp %= 100;
+		memcpy(p, digit_pairs + exp * 2, 2);
+		p += 2;
+	} else if (exp >= 10) {
+		memcpy(p, digit_pairs + exp * 2, 2);
+		p += 2;
+	} else
+		*p++ = (char)('0' + exp);
+	return (int)(p - buf);
+}
+
+/*
+ * Lay out digits * 10^k like JavaScript: plain notation for magnitudes in
+ * [1e-6, 1e21), exponent notation otherwise ("1e30", "1.5e-7").
+ */
+static int prettify(char *buf, int len, int k) {
+	int kk = len + k; // 10^(kk - 1) <= v < 10^kk
+
+	if (k >= 0 && kk <= 21) {
+		memset(buf + len, '0', (size_t)k);
+		return kk;
+	}
+	if (kk > 0 && kk <= 21) {
+		memmove(buf + kk + 1, buf + kk, (size_t)(len - kk));
+		buf[kk] = '.';
+		return len + 1;
+	}
+	if (kk > -6 && kk <= 0) {
+		int offset = 2 - kk;
+		memmove(buf + offset, buf, (size_t)len);
+		buf[0] = '0';
+		buf[1] = '.';
+		memset(buf + 2, '0', (size_t)(offset - 2));
+		return len + offset;
+	}
+	if (len == 1) {
+		buf[1] = 'e';
+		return 2 + write_exponent(buf + 2, kk - 1);
+	}
+	memmove(buf + 2, buf + 1, (size_t)(len - 1));
+	buf[1]	 = '.';
+	buf[len + 1] = 'e';
+	return len + 2 + write_exponent(buf + len + 2, kk - 1);
+}
+
+size_t str_format_double(char *buf, double value) {
+	char *p = buf;
+	int len, k;
+
+	if (isnan(value)) {
+		memcpy(buf, "nan", 4);
+		return 3;
+	}
+	if (signbit(value)) {
+		*p++  = '-';
+		value = -value;
+	}
+	if (isinf(value)) {
+		memcpy(p, "inf", 4);
+		return (size_t)(p - buf) + 3;
+	}
+	if (value == 0.0) {
+		memcpy(p, "0", 2);
+		return (size_t)(p - buf) + 1;
+	}
+	len	   = grisu2(value, p, &k);
+	len	   = prettify(p, len, k);
+	p[len] = '\0';
+	return (size_t)(p - buf) + (size_t)len;
+}
+
+static const uint64_t cached_powers_f[CACHED_POWERS] = {
+	0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+	0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+	0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+	0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+	0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+	0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+	0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+	0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+	0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+	0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+	0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+	0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+	0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+	0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+	0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+	0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+	0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+	0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+	0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+	0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+	0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+	0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+	0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+	0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+	0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+	0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+	0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+	0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+	0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+static const int16_t cached_powers_e[CACHED_POWERS] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066,
+};
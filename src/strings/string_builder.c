@@ -0,0 +1,399 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_builder.c                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../includes/lib/strings/string_builder.h"
+#include "../../includes/lib/strings/string_search.h"
+#include "../../includes/lib/strings/strings.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STR_BUILDER_MIN_CAPACITY 15
+
+static bool is_trim_space(char c) {
+	return c == ' ' || c == '\t' || c == '\n';
+}
+
+/*
+ * Sources may point into sb's own buffer (appending a builder to itself),
+ * which str_builder_reserve can move: such pointers are kept as offsets.
+ */
+static bool points_into(const StrBuilder *sb, const char *data, size_t *offset) {
+	uintptr_t start = (uintptr_t)sb->data;
+	uintptr_t ptr	= (uintptr_t)data;
+
+	if (!sb->data || ptr < start || ptr > start + sb->capacity)
+		return false;
+	*offset = ptr - start;
+	return true;
+}
+
+/* Lifetime */
+bool str_builder_init(StrBuilder *sb, size_t capacity) {
+	if (!sb)
+		return false;
+	sb->data	 = NULL;
+	sb->len		 = 0;
+	sb->capacity = 0;
+	return str_builder_reserve(sb, capacity);
+}
+
+bool str_builder_from(StrBuilder *sb, const char *str) {
+	size_t len = str_len(str);
+
+	if (!str_builder_init(sb, len))
+		return false;
+	return str_builder_append_len(sb, str, len);
+}
+
+void str_builder_destroy(StrBuilder *sb) {
+	if (!sb)
+		return;
+	free(sb->data);
+	sb->data	 = NULL;
+	sb->len		 = 0;
+	sb->capacity = 0;
+}
+
+bool str_builder_reserve(StrBuilder *sb, size_t extra) {
+	size_t needed, capacity;
+	char *data;
+
+	if (sb->data && extra <= sb->capacity - sb->len)
+		return true;
+	if (extra > SIZE_MAX - 1 - sb->len)
+		return false;
+	needed	 = sb->len + extra;
+	capacity = (sb->capacity > STR_BUILDER_MIN_CAPACITY) ? sb->capacity : STR_BUILDER_MIN_CAPACITY;
+	// Doubling keeps a series of appends linear overall
+	while (capacity < needed)
+		capacity = (capacity > (SIZE_MAX - 1) / 2) ? needed : capacity * 2 + 1;
+	data = realloc(sb->data, capacity + 1);
+	if (!data)
+		return false;
+	data[sb->len] = '\0';
+	sb->data	  = data;
+	sb->capacity  = capacity;
+	return true;
+}
+
+bool str_builder_shrink(StrBuilder *sb) {
+	char *data;
+
+	if (!sb->data || sb->capacity == sb->len)
+		return true;
+	data = realloc(sb->data, sb->len + 1);
+	if (!data)
+		return false;
+	sb->data	 = data;
+	sb->capacity = sb->len;
+	return true;
+}
+
+void str_builder_clear(StrBuilder *sb) {
+	sb->len = 0;
+	if (sb->data)
+		sb->data[0] = '\0';
+}
+
+/* Conversion */
+const char *str_builder_cstr(const StrBuilder *sb) {
+	return (sb && sb->data) ? sb->data : "";
+}
+
+char *str_builder_detach(StrBuilder *sb) {
+	char *data;
+
+	// An empty builder may not own a buffer yet, but callers expect one
+	if (!sb->data && !str_builder_reserve(sb, 0))
+		return NULL;
+	data		 = sb->data;
+	sb->data	 = NULL;
+	sb->len		 = 0;
+	sb->capacity = 0;
+	return data;
+}
+
+size_t str_builder_len(const StrBuilder *sb) {
+	return sb ? sb->len : 0;
+}
+
+/* Appending */
+bool str_builder_append(StrBuilder *sb, const char *str) {
+	return str_builder_append_len(sb, str, str_len(str));
+}
+
+bool str_builder_append_len(StrBuilder *sb, const char *data, size_t len) {
+	size_t offset;
+	bool self = points_into(sb, data, &offset);
+
+	if (!str_builder_reserve(sb, len))
+		return false;
+	if (self)
+		data = sb->data + offset;
+	if (len)
+		memcpy(sb->data + sb->len, data, len);
+	sb->len += len;
+	sb->data[sb->len] = '\0';
+	return true;
+}
+
+bool str_builder_append_char(StrBuilder *sb, char c) {
+	if (!str_builder_reserve(sb, 1))
+		return false;
+	sb->data[sb->len++] = c;
+	sb->data[sb->len]	= '\0';
+	return true;
+}
+
+bool str_builder_append_repeat(StrBuilder *sb, char c, size_t count) {
+	if (!str_builder_reserve(sb, count))
+		return false;
+	memset(sb->data + sb->len, c, count);
+	sb->len += count;
+	sb->data[sb->len] = '\0';
+	return true;
+}
+
+bool str_builder_vappendf(StrBuilder *sb, const char *format, va_list args) {
+	va_list retry;
+	int written;
+
+	if (!str_builder_reserve(sb, 0))
+		return false;
+	// Format straight into the spare capacity; only retry if it did not fit
+	va_copy(retry, args);
+	written = vsnprintf(sb->data + sb->len, sb->capacity - sb->len + 1, format, args);
+	if (written < 0) {
+		va_end(retry);
+		sb->data[sb->len] = '\0';
+		return false;
+	}
+	if ((size_t)written > sb->capacity - sb->len) {
+		if (!str_builder_reserve(sb, (size_t)written)) {
+			va_end(retry);
+			sb->data[sb->len] = '\0';
+			return false;
+		}
+		vsnprintf(sb->data + sb->len, sb->capacity - sb->len + 1, format, retry);
+	}
+	va_end(retry);
+	sb->len += (size_t)written;
+	return true;
+}
+
+bool str_builder_appendf(StrBuilder *sb, const char *format, ...) {
+	va_list args;
+	bool ok;
+
+	va_start(args, format);
+	ok = str_builder_vappendf(sb, format, args);
+	va_end(args);
+	return ok;
+}
+
+bool str_builder_join(StrBuilder *sb, const char **strings, const char *delim) {
+	size_t start	 = sb->len;
+	size_t delim_len = str_len(delim);
+
+	for (size_t i = 0; strings && strings[i]; i++) {
+		if ((i > 0 && !str_builder_append_len(sb, delim, delim_len)) || !str_builder_append(sb, strings[i])) {
+			str_builder_truncate(sb, start);
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Numbers are formatted straight into the spare capacity */
+bool str_builder_append_i64(StrBuilder *sb, int64_t value) {
+	if (!str_builder_reserve(sb, STR_I64_BUFSIZE))
+		return false;
+	sb->len += str_format_i64(sb->data + sb->len, value);
+	return true;
+}
+
+bool str_builder_append_u64(StrBuilder *sb, uint64_t value) {
+	if (!str_builder_reserve(sb, STR_I64_BUFSIZE))
+		return false;
+	sb->len += str_format_u64(sb->data + sb->len, value);
+	return true;
+}
+
+bool str_builder_append_double(StrBuilder *sb, double value) {
+	if (!str_builder_reserve(sb, STR_DOUBLE_BUFSIZE))
+		return false;
+	sb->len += str_format_double(sb->data + sb->len, value);
+	return true;
+}
+
+/* Editing */
+bool str_builder_insert(StrBuilder *sb, size_t pos, const char *str) {
+	size_t len = str_len(str);
+	size_t offset;
+	bool self = points_into(sb, str, &offset);
+
+	if (pos > sb->len)
+		pos = sb->len;
+	if (!str_builder_reserve(sb, len))
+		return false;
+	memmove(sb->data + pos + len, sb->data + pos, sb->len - pos + 1);
+	if (self) {
+		// Source bytes before pos stayed put, the others moved up by len
+		size_t before = (offset < pos) ? pos - offset : 0;
+		if (before > len)
+			before = len;
+		memcpy(sb->data + pos, sb->data + offset, before);
+		memcpy(sb->data + pos + before, sb->data + offset + before + len, len - before);
+	} else
+		memcpy(sb->data + pos, str, len);
+	sb->len += len;
+	return true;
+}
+
+void str_builder_erase(StrBuilder *sb, size_t pos, size_t len) {
+	if (pos >= sb->len)
+		return;
+	if (len > sb->len - pos)
+		len = sb->len - pos;
+	memmove(sb->data + pos, sb->data + pos + len, sb->len - pos - len + 1);
+	sb->len -= len;
+}
+
+void str_builder_truncate(StrBuilder *sb, size_t len) {
+	if (len >= sb->len)
+		return;
+	sb->len			  = len;
+	sb->data[sb->len] = '\0';
+}
+
+bool str_builder_replace(StrBuilder *sb, const char *old, const char *new) {
+	size_t old_len = str_len(old);
+	size_t new_len = str_len(new);
+	const char *src, *end, *match;
+	StrSearcher searcher;
+	StrBuilder out;
+
+	if (!old_len || !sb->data)
+		return true;
+	str_searcher_init(&searcher, old, old_len);
+	src = sb->data;
+	end = sb->data + sb->len;
+
+	if (new_len <= old_len) {
+		// Output never overtakes input: compact in place
+		char *dest = sb->data;
+		while ((match = str_searcher_find(&searcher, src, end - src))) {
+			memmove(dest, src, match - src);
+			dest += match - src;
+			memcpy(dest, new, new_len);
+			dest += new_len;
+			src = match + old_len;
+		}
+		memmove(dest, src, end - src);
+		dest += end - src;
+		sb->len	= dest - sb->data;
+		*dest	= '\0';
+		return true;
+	}
+	if (!str_builder_init(&out, sb->len))
+		return false;
+	while ((match = str_searcher_find(&searcher, src, end - src))) {
+		if (!str_builder_append_len(&out, src, match - src) || !str_builder_append_len(&out, new, new_len)) {
+			str_builder_destroy(&out);
+			return false;
+		}
+		src = match + old_len;
+	}
+	if (!str_builder_append_len(&out, src, end - src)) {
+		str_builder_destroy(&out);
+		return false;
+	}
+	str_builder_destroy(sb);
+	*sb = out;
+	return true;
+}
+
+/* Manipulation */
+void str_builder_upper(StrBuilder *sb) {
+	str_mem_upper(sb->data, sb->data, sb->len);
+}
+
+void str_builder_lower(StrBuilder *sb) {
+	str_mem_lower(sb->data, sb->data, sb->len);
+}
+
+void str_builder_capitalize(StrBuilder *sb) {
+	if (!sb->len)
+		return;
+	str_builder_lower(sb);
+	if (sb->data[0] >= 'a' && sb->data[0] <= 'z')
+		sb->data[0] -= 32;
+}
+
+void str_builder_reverse(StrBuilder *sb) {
+	for (size_t i = 0; i < sb->len / 2; i++) {
+		char tmp					= sb->data[i];
+		sb->data[i]					= sb->data[sb->len - 1 - i];
+		sb->data[sb->len - 1 - i] = tmp;
+	}
+}
+
+void str_builder_trim_left(StrBuilder *sb) {
+	size_t skip = 0;
+
+	while (skip < sb->len && is_trim_space(sb->data[skip]))
+		skip++;
+	str_builder_erase(sb, 0, skip);
+}
+
+void str_builder_trim_right(StrBuilder *sb) {
+	size_t len = sb->len;
+
+	while (len > 0 && is_trim_space(sb->data[len - 1]))
+		len--;
+	str_builder_truncate(sb, len);
+}
+
+void str_builder_trim(StrBuilder *sb) {
+	str_builder_trim_right(sb);
+	str_builder_trim_left(sb);
+}
+
+/* Queries */
+size_t str_builder_find(const StrBuilder *sb, const char *needle, size_t from) {
+	const char *match;
+
+	if (!needle || from > sb->len)
+		return STR_BUILDER_NPOS;
+	match = str_memstr(str_builder_cstr(sb) + from, sb->len - from, needle, str_len(needle));
+	return match ? (size_t)(match - sb->data) : STR_BUILDER_NPOS;
+}
+
+bool str_builder_equals(const StrBuilder *sb, const char *str) {
+	size_t len = str_len(str);
+
+	return str && len == sb->len && memcmp(str_builder_cstr(sb), str, len) == 0;
+}
+
+bool str_builder_starts_with(const StrBuilder *sb, const char *prefix) {
+	size_t len = str_len(prefix);
+
+	return prefix && len <= sb->len && memcmp(str_builder_cstr(sb), prefix, len) == 0;
+}
+
+bool str_builder_ends_with(const StrBuilder *sb, const char *suffix) {
+	size_t len = str_len(suffix);
+
+	return suffix && len <= sb->len && memcmp(str_builder_cstr(sb) + sb->len - len, suffix, len) == 0;
+}
@@ -0,0 +1,176 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_intern.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../includes/lib/strings/string_intern.h"
+#include "../../includes/lib/algorithms/compare.h"
+#include "../../includes/lib/strings/strings.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERN_CHUNK_SIZE 4096
+#define INTERN_MIN_CAPACITY 64
+
+/* FNV-1a over the string a key points to */
+static unsigned int intern_hash(const void *key) {
+	const unsigned char *s = *(const unsigned char *const *)key;
+	unsigned int hash	   = 2166136261u;
+
+	while (*s) {
+		hash ^= *s++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * Room for len + 1 bytes at the arena's tip. The space is only claimed by
+ * arena_commit, so a string that turns out to be interned already costs
+ * nothing.
+ */
+static char *arena_tip(StrInternPool *pool, size_t len) {
+	StrInternChunk *chunk = pool->chunks;
+	size_t capacity;
+
+	if (chunk && chunk->capacity - chunk->used > len)
+		return chunk->data + chunk->used;
+	capacity = (len + 1 > INTERN_CHUNK_SIZE) ? len + 1 : INTERN_CHUNK_SIZE;
+	chunk	 = malloc(sizeof(StrInternChunk) + capacity);
+	if (!chunk)
+		return NULL;
+	chunk->used		= 0;
+	chunk->capacity = capacity;
+	chunk->next		= pool->chunks;
+	pool->chunks	= chunk;
+	return chunk->data;
+}
+
+static void arena_commit(StrInternPool *pool, size_t len) {
+	pool->chunks->used += len + 1;
+	pool->bytes += len + 1;
+}
+
+static bool grow_strings(StrInternPool *pool) {
+	size_t capacity = pool->capacity ? pool->capacity * 2 : INTERN_MIN_CAPACITY;
+	const char **strings;
+
+	if (capacity > STR_INTERN_NONE)
+		return false;
+	strings = realloc(pool->strings, capacity * sizeof(*strings));
+	if (!strings)
+		return false;
+	pool->strings  = strings;
+	pool->capacity = capacity;
+	return true;
+}
+
+bool str_intern_init(StrInternPool *pool, size_t initial_capacity) {
+	if (!pool)
+		return false;
+	if (initial_capacity < INTERN_MIN_CAPACITY)
+		initial_capacity = INTERN_MIN_CAPACITY;
+	memset(pool, 0, sizeof(*pool));
+	return hash_table_init(&pool->table, initial_capacity, sizeof(const char *), intern_hash, compare_str);
+}
+
+void str_intern_destroy(StrInternPool *pool) {
+	StrInternChunk *chunk;
+
+	if (!pool)
+		return;
+	hash_table_destroy(&pool->table);
+	free(pool->strings);
+	while ((chunk = pool->chunks)) {
+		pool->chunks = chunk->next;
+		free(chunk);
+	}
+	memset(pool, 0, sizeof(*pool));
+}
+
+/* Staged copy at the arena tip: returns its id, adding it when new */
+static uint32_t intern_staged(StrInternPool *pool, const char *staged, size_t len) {
+	uint32_t *found = hash_table_find(&pool->table, &staged);
+	uint32_t id;
+
+	if (found)
+		return *found;
+	if (pool->count == pool->capacity && !grow_strings(pool))
+		return STR_INTERN_NONE;
+	id = (uint32_t)pool->count;
+	if (!hash_table_insert(&pool->table, &staged, &id, sizeof(id)))
+		return STR_INTERN_NONE;
+	arena_commit(pool, len);
+	pool->strings[pool->count++] = staged;
+	return id;
+}
+
+static uint32_t intern_copy(StrInternPool *pool, const char *data, size_t len) {
+	char *staged = arena_tip(pool, len);
+
+	if (!staged)
+		return STR_INTERN_NONE;
+	memcpy(staged, data, len);
+	staged[len] = '\0';
+	return intern_staged(pool, staged, len);
+}
+
+uint32_t str_intern_id(StrInternPool *pool, const char *str) {
+	uint32_t *found;
+
+	if (!pool || !str)
+		return STR_INTERN_NONE;
+	// Hits, the common case, never touch the arena
+	found = hash_table_find(&pool->table, &str);
+	if (found)
+		return *found;
+	return intern_copy(pool, str, str_len(str));
+}
+
+const char *str_intern(StrInternPool *pool, const char *str) {
+	uint32_t id = str_intern_id(pool, str);
+
+	return (id == STR_INTERN_NONE) ? NULL : pool->strings[id];
+}
+
+const char *str_intern_len(StrInternPool *pool, const char *data, size_t len) {
+	uint32_t id;
+
+	if (!pool || (!data && len) || (len && memchr(data, '\0', len)))
+		return NULL;
+	// Not NUL-terminated, so stage it in the arena to look it up
+	id = intern_copy(pool, data ? data : "", len);
+	return (id == STR_INTERN_NONE) ? NULL : pool->strings[id];
+}
+
+uint32_t str_intern_lookup_id(const StrInternPool *pool, const char *str) {
+	const uint32_t *found;
+
+	if (!pool || !str)
+		return STR_INTERN_NONE;
+	found = hash_table_find(&pool->table, &str);
+	return found ? *found : STR_INTERN_NONE;
+}
+
+const char *str_intern_lookup(const StrInternPool *pool, const char *str) {
+	uint32_t id = str_intern_lookup_id(pool, str);
+
+	return (id == STR_INTERN_NONE) ? NULL : pool->strings[id];
+}
+
+const char *str_intern_string(const StrInternPool *pool, uint32_t id) {
+	if (!pool || id >= pool->count)
+		return NULL;
+	return pool->strings[id];
+}
+
+size_t str_intern_count(const StrInternPool *pool) {
+	return pool ? pool->count : 0;
+}
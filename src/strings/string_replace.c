@@ -0,0 +1,215 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_replace.c                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../includes/lib/strings/string_replace.h"
+#include "../../includes/lib/strings/string_search.h"
+#include "../../includes/lib/strings/strings.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ENTRY_NONE UINT32_MAX
+
+/* Output target: a bounded buffer (lcpy semantics) or a StrBuilder */
+typedef struct ReplaceSink {
+	char *dest;
+	size_t size;
+	size_t pos;
+	StrBuilder *builder;
+	bool ok;
+} ReplaceSink;
+
+static void sink_emit(ReplaceSink *sink, const char *data, size_t n) {
+	if (!n)
+		return;
+	if (sink->builder) {
+		if (sink->ok && !str_builder_append_len(sink->builder, data, n))
+			sink->ok = false;
+		return;
+	}
+	if (sink->size && sink->pos < sink->size - 1) {
+		size_t room = sink->size - 1 - sink->pos;
+		// memmove: replacing in place reads ahead of where it writes
+		memmove(sink->dest + sink->pos, data, (n < room) ? n : room);
+	}
+	sink->pos += n;
+}
+
+static void sink_finish(ReplaceSink *sink) {
+	if (!sink->builder && sink->size)
+		sink->dest[(sink->pos < sink->size) ? sink->pos : sink->size - 1] = '\0';
+}
+
+/* Single pair */
+static void replace_one(const char *str, size_t len, const char *old, const char *new, ReplaceSink *sink) {
+	size_t old_len = str_len(old);
+	size_t new_len = str_len(new);
+	const char *end = str + len;
+	const char *match;
+	StrSearcher searcher;
+
+	if (!old_len) {
+		sink_emit(sink, str, len);
+		return;
+	}
+	str_searcher_init(&searcher, old, old_len);
+	while ((match = str_searcher_find(&searcher, str, end - str))) {
+		sink_emit(sink, str, match - str);
+		sink_emit(sink, new, new_len);
+		str = match + old_len;
+	}
+	sink_emit(sink, str, end - str);
+}
+
+size_t str_replace_into(char *dest, size_t size, const char *str, const char *old, const char *new) {
+	ReplaceSink sink = {dest, dest ? size : 0, 0, NULL, true};
+
+	if (str)
+		replace_one(str, str_len(str), old, new, &sink);
+	sink_finish(&sink);
+	return sink.pos;
+}
+
+bool str_builder_append_replace(StrBuilder *sb, const char *str, const char *old, const char *new) {
+	ReplaceSink sink = {NULL, 0, 0, sb, true};
+	size_t start	 = sb->len;
+
+	if (str)
+		replace_one(str, str_len(str), old, new, &sink);
+	if (!sink.ok)
+		str_builder_truncate(sb, start);
+	return sink.ok;
+}
+
+/* Batch replacement */
+bool str_replacer_init(StrReplacer *replacer, const StrReplacePair *pairs, size_t count) {
+	if (!replacer || (!pairs && count) || count >= ENTRY_NONE)
+		return false;
+	replacer->pairs		  = pairs;
+	replacer->count		  = count;
+	replacer->first_bytes = 0;
+	replacer->only_first  = 0;
+	for (size_t b = 0; b < 256; b++)
+		replacer->bucket[b] = ENTRY_NONE;
+	replacer->entries = malloc((count ? count : 1) * sizeof(StrReplaceEntry));
+	if (!replacer->entries)
+		return false;
+
+	for (size_t i = 0; i < count; i++) {
+		StrReplaceEntry *entry = &replacer->entries[i];
+		unsigned char first;
+		uint32_t *link;
+
+		entry->old_len = str_len(pairs[i].old);
+		entry->new_len = str_len(pairs[i].new);
+		entry->next	   = ENTRY_NONE;
+		if (!entry->old_len)
+			continue;
+		first = (unsigned char)pairs[i].old[0];
+		if (replacer->bucket[first] == ENTRY_NONE) {
+			replacer->first_bytes++;
+			replacer->only_first = first;
+		}
+		// Keep each bucket longest first, earlier pairs first on ties
+		link = &replacer->bucket[first];
+		while (*link != ENTRY_NONE && replacer->entries[*link].old_len >= entry->old_len)
+			link = &replacer->entries[*link].next;
+		entry->next = *link;
+		*link		= (uint32_t)i;
+	}
+	return true;
+}
+
+void str_replacer_destroy(StrReplacer *replacer) {
+	if (!replacer)
+		return;
+	free(replacer->entries);
+	replacer->entries = NULL;
+	replacer->count	  = 0;
+}
+
+static void replace_many(const StrReplacer *r, const char *str, size_t len, ReplaceSink *sink) {
+	const unsigned char *s = (const unsigned char *)str;
+	size_t copied		   = 0;
+	size_t i			   = 0;
+
+	while (i < len && r->first_bytes) {
+		uint32_t e;
+
+		// Jump to the next byte that can start a match
+		if (r->first_bytes == 1) {
+			const unsigned char *p = memchr(s + i, r->only_first, len - i);
+			if (!p)
+				break;
+			i = p - s;
+		} else {
+			while (i < len && r->bucket[s[i]] == ENTRY_NONE)
+				i++;
+			if (i == len)
+				break;
+		}
+		for (e = r->bucket[s[i]]; e != ENTRY_NONE; e = r->entries[e].next)
+			if (r->entries[e].old_len <= len - i && memcmp(s + i, r->pairs[e].old, r->entries[e].old_len) == 0)
+				break;
+		if (e == ENTRY_NONE) {
+			i++;
+			continue;
+		}
+		sink_emit(sink, str + copied, i - copied);
+		sink_emit(sink, r->pairs[e].new, r->entries[e].new_len);
+		i += r->entries[e].old_len;
+		copied = i;
+	}
+	sink_emit(sink, str + copied, len - copied);
+}
+
+size_t str_replacer_apply_into(const StrReplacer *replacer, const char *str, size_t len, char *dest, size_t size) {
+	ReplaceSink sink = {dest, dest ? size : 0, 0, NULL, true};
+
+	if (str)
+		replace_many(replacer, str, len, &sink);
+	sink_finish(&sink);
+	return sink.pos;
+}
+
+bool str_replacer_apply(const StrReplacer *replacer, const char *str, size_t len, StrBuilder *out) {
+	ReplaceSink sink = {NULL, 0, 0, out, true};
+	size_t start	 = out->len;
+
+	if (str)
+		replace_many(replacer, str, len, &sink);
+	if (sink.ok && !str_builder_reserve(out, 0))
+		sink.ok = false;
+	if (!sink.ok)
+		str_builder_truncate(out, start);
+	return sink.ok;
+}
+
+char *str_replace_many(const char *str, const StrReplacePair *pairs, size_t count) {
+	StrReplacer replacer;
+	StrBuilder out;
+	size_t len = str_len(str);
+	bool ok;
+
+	if (!str || !str_replacer_init(&replacer, pairs, count))
+		return NULL;
+	if (!str_builder_init(&out, len)) {
+		str_replacer_destroy(&replacer);
+		return NULL;
+	}
+	ok = str_replacer_apply(&replacer, str, len, &out);
+	str_replacer_destroy(&replacer);
+	if (!ok) {
+		str_builder_destroy(&out);
+		return NULL;
+	}
+	return str_builder_detach(&out);
+}
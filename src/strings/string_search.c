@@ -0,0 +1,246 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_search.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../includes/lib/strings/string_search.h"
+#include "../../includes/lib/strings/strings.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STR_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+/* Position of the maximal suffix of the needle, for either byte order */
+static size_t maximal_suffix(const unsigned char *n, size_t len, size_t *period, bool reversed) {
+	size_t ms = SIZE_MAX; // Wraps to 0 when a position is added
+	size_t j  = 0;
+	size_t k  = 1;
+
+	*period = 1;
+	while (j + k < len) {
+		unsigned char a = n[ms + k];
+		unsigned char b = n[j + k];
+		if (a == b) {
+			if (k == *period) {
+				j += *period;
+				k = 1;
+			} else
+				k++;
+		} else if (reversed ? a < b : a > b) {
+			j += k;
+			k		= 1;
+			*period = j - ms;
+		} else {
+			ms = j++;
+			k = *period = 1;
+		}
+	}
+	return ms;
+}
+
+static void two_way_init(StrSearcher *s) {
+	const unsigned char *n = s->needle;
+	size_t len			   = s->len;
+	size_t p1, p2;
+	size_t ms1 = maximal_suffix(n, len, &p1, false);
+	size_t ms2 = maximal_suffix(n, len, &p2, true);
+
+	// Critical factorisation: the later of the two maximal suffixes
+	if (ms2 + 1 > ms1 + 1) {
+		s->critical = ms2 + 1;
+		s->period	= p2;
+	} else {
+		s->critical = ms1 + 1;
+		s->period	= p1;
+	}
+	if (memcmp(n, n + s->period, s->critical) == 0)
+		s->memory = len - s->period;
+	else {
+		s->memory = 0;
+		// Non-periodic needles never overlap themselves past this shift
+		s->period = ((s->critical - 1 > len - s->critical) ? s->critical - 1 : len - s->critical) + 1;
+	}
+	for (size_t i = 0; i < 256; i++)
+		s->shift[i] = 0;
+	for (size_t i = 0; i < len; i++)
+		s->shift[n[i]] = i + 1;
+}
+
+static char *two_way_find(const StrSearcher *s, const unsigned char *h, const unsigned char *end) {
+	const unsigned char *n = s->needle;
+	size_t len			   = s->len;
+	size_t mem			   = 0;
+	size_t k;
+
+	while ((size_t)(end - h) >= len) {
+		// Bad-character skip on the last window byte
+		k = len - s->shift[h[len - 1]];
+		if (k) {
+			if (k < mem)
+				k = mem;
+			h += k;
+			mem = 0;
+			continue;
+		}
+		// Right half, then left half down to what is already known to match
+		for (k = (s->critical > mem) ? s->critical : mem; k < len && n[k] == h[k]; k++)
+			;
+		if (k < len) {
+			h += k - s->critical + 1;
+			mem = 0;
+			continue;
+		}
+		for (k = s->critical; k > mem && n[k - 1] == h[k - 1]; k--)
+			;
+		if (k <= mem)
+			return (char *)h;
+		h += s->period;
+		mem = s->memory;
+	}
+	return NULL;
+}
+
+static void horspool_init(StrSearcher *s) {
+	for (size_t i = 0; i < 256; i++)
+		s->shift[i] = s->len;
+	for (size_t i = 0; i + 1 < s->len; i++)
+		s->shift[s->needle[i]] = s->len - 1 - i;
+}
+
+static char *horspool_find(const StrSearcher *s, const unsigned char *h, const unsigned char *end) {
+	const unsigned char *n = s->needle;
+	size_t len			   = s->len;
+	unsigned char last	   = n[len - 1];
+
+	while ((size_t)(end - h) >= len) {
+		unsigned char c = h[len - 1];
+		if (c == last && memcmp(h, n, len - 1) == 0)
+			return (char *)h;
+		h += s->shift[c];
+	}
+	return NULL;
+}
+
+/* Candidates are windows whose first and last bytes match the needle's */
+static char *filter_scalar(const StrSearcher *s, const unsigned char *h, const unsigned char *end) {
+	const unsigned char *n = s->needle;
+	size_t len			   = s->len;
+
+	while ((size_t)(end - h) >= len) {
+		h = memchr(h, n[0], (end - h) - len + 1);
+		if (!h)
+			return NULL;
+		if (h[len - 1] == n[len - 1] && memcmp(h + 1, n + 1, len - 2) == 0)
+			return (char *)h;
+		h++;
+	}
+	return NULL;
+}
+
+#ifdef STR_SEARCH_X86
+
+#define DEFINE_FILTER(suffix, ISA, W, vec, LOADU, SET1, CMPEQ, AND, MOVEMASK)                                   \
+	__attribute__((target(ISA))) static char *filter_##suffix(const StrSearcher *s, const unsigned char *h,     \
+															  const unsigned char *end) {                        \
+		const unsigned char *n = s->needle;                                                                     \
+		size_t len			   = s->len;                                                                        \
+		const vec first		   = SET1((char)n[0]);                                                              \
+		const vec last		   = SET1((char)n[len - 1]);                                                        \
+		for (; (size_t)(end - h) >= len - 1 + W; h += W) {                                                      \
+			vec a		  = LOADU((const vec *)h);                                                              \
+			vec b		  = LOADU((const vec *)(h + len - 1));                                                  \
+			uint32_t mask = (uint32_t)MOVEMASK(AND(CMPEQ(a, first), CMPEQ(b, last)));                           \
+			while (mask) {                                                                                      \
+				size_t i = __builtin_ctz(mask);                                                                 \
+				if (memcmp(h + i + 1, n + 1, len - 2) == 0)                                                     \
+					return (char *)(h + i);                                                                     \
+				mask &= mask - 1;                                                                               \
+			}                                                                                                   \
+		}                                                                                                       \
+		return filter_scalar(s, h, end);                                                                        \
+	}
+
+DEFINE_FILTER(sse2, "sse2", 16, __m128i, _mm_loadu_si128, _mm_set1_epi8, _mm_cmpeq_epi8, _mm_and_si128,
+			  _mm_movemask_epi8)
+DEFINE_FILTER(avx2, "avx2", 32, __m256i, _mm256_loadu_si256, _mm256_set1_epi8, _mm256_cmpeq_epi8, _mm256_and_si256,
+			  _mm256_movemask_epi8)
+
+#endif /* STR_SEARCH_X86 */
+
+static char *filter_find(const StrSearcher *s, const unsigned char *h, const unsigned char *end) {
+#ifdef STR_SEARCH_X86
+	// Follows the level chosen (or forced) for the string primitives
+	switch (str_simd_level()) {
+	case STR_SIMD_AVX2:
+		return filter_avx2(s, h, end);
+	case STR_SIMD_SSE2:
+		return filter_sse2(s, h, end);
+	default:
+		break;
+	}
+#endif
+	return filter_scalar(s, h, end);
+}
+
+void str_searcher_init(StrSearcher *searcher, const char *needle, size_t needle_len) {
+	searcher->needle = (const unsigned char *)needle;
+	searcher->len	 = needle_len;
+	if (needle_len == 0)
+		searcher->kind = STR_SEARCH_EMPTY;
+	else if (needle_len == 1)
+		searcher->kind = STR_SEARCH_BYTE;
+	else if (needle_len <= STR_SEARCH_FILTER_MAX)
+		searcher->kind = STR_SEARCH_FILTER;
+	else if (needle_len <= STR_SEARCH_HORSPOOL_MAX) {
+		searcher->kind = STR_SEARCH_HORSPOOL;
+		horspool_init(searcher);
+	} else {
+		searcher->kind = STR_SEARCH_TWO_WAY;
+		two_way_init(searcher);
+	}
+}
+
+char *str_searcher_find(const StrSearcher *searcher, const char *haystack, size_t haystack_len) {
+	const unsigned char *h	 = (const unsigned char *)haystack;
+	const unsigned char *end = h + haystack_len;
+
+	if (!haystack)
+		return NULL;
+	if (searcher->len > haystack_len)
+		return NULL;
+	switch (searcher->kind) {
+	case STR_SEARCH_EMPTY:
+		return (char *)haystack;
+	case STR_SEARCH_BYTE:
+		return memchr(haystack, searcher->needle[0], haystack_len);
+	case STR_SEARCH_FILTER:
+		return filter_find(searcher, h, end);
+	case STR_SEARCH_HORSPOOL:
+		return horspool_find(searcher, h, end);
+	default:
+		return two_way_find(searcher, h, end);
+	}
+}
+
+char *str_memstr(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len) {
+	StrSearcher searcher;
+
+	if (!haystack || !needle || needle_len > haystack_len)
+		return NULL;
+	// Skip the table setup when there is nothing to gain from it
+	if (needle_len == 1)
+		return memchr(haystack, *needle, haystack_len);
+	str_searcher_init(&searcher, needle, needle_len);
+	return str_searcher_find(&searcher, haystack, haystack_len);
+}
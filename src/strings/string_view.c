@@ -0,0 +1,165 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   string_view.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../includes/lib/strings/string_view.h"
+#include "../../includes/lib/strings/strings.h"
+#include <stdlib.h>
+#include <string.h>
+
+static bool is_trim_space(char c) {
+	return c == ' ' || c == '\t' || c == '\n';
+}
+
+/* Construction and conversion */
+StrView str_view(const char *str) {
+	return (StrView){str ? str : "", str_len(str)};
+}
+
+StrView str_view_len(const char *data, size_t len) {
+	return (StrView){data ? data : "", data ? len : 0};
+}
+
+StrView str_view_sub(StrView view, size_t start, size_t len) {
+	if (start > view.len)
+		start = view.len;
+	if (len > view.len - start)
+		len = view.len - start;
+	return (StrView){view.data + start, len};
+}
+
+size_t str_view_copy(StrView view, char *dest, size_t size) {
+	// str_lcpy semantics: always terminated, returns the length it needed
+	if (size) {
+		size_t n = (view.len < size - 1) ? view.len : size - 1;
+		memcpy(dest, view.data, n);
+		dest[n] = '\0';
+	}
+	return view.len;
+}
+
+char *str_view_dup(StrView view) {
+	char *copy = malloc(view.len + 1);
+
+	if (!copy)
+		return NULL;
+	memcpy(copy, view.data, view.len);
+	copy[view.len] = '\0';
+	return copy;
+}
+
+/* Trimming */
+StrView str_view_trim_left(StrView view) {
+	while (view.len && is_trim_space(*view.data)) {
+		view.data++;
+		view.len--;
+	}
+	return view;
+}
+
+StrView str_view_trim_right(StrView view) {
+	while (view.len && is_trim_space(view.data[view.len - 1]))
+		view.len--;
+	return view;
+}
+
+StrView str_view_trim(StrView view) {
+	return str_view_trim_left(str_view_trim_right(view));
+}
+
+/* Comparison and search */
+bool str_view_empty(StrView view) {
+	return view.len == 0;
+}
+
+bool str_view_equals(StrView a, StrView b) {
+	return a.len == b.len && memcmp(a.data, b.data, a.len) == 0;
+}
+
+bool str_view_case_equals(StrView a, StrView b) {
+	return a.len == b.len && str_mem_case_equals(a.data, b.data, a.len);
+}
+
+int str_view_cmp(StrView a, StrView b) {
+	int diff = memcmp(a.data, b.data, (a.len < b.len) ? a.len : b.len);
+
+	if (diff)
+		return diff;
+	return (a.len > b.len) - (a.len < b.len);
+}
+
+bool str_view_starts_with(StrView view, StrView prefix) {
+	return prefix.len <= view.len && memcmp(view.data, prefix.data, prefix.len) == 0;
+}
+
+bool str_view_ends_with(StrView view, StrView suffix) {
+	return suffix.len <= view.len && memcmp(view.data + view.len - suffix.len, suffix.data, suffix.len) == 0;
+}
+
+size_t str_view_find(StrView view, StrView needle) {
+	const char *match = str_memstr(view.data, view.len, needle.data, needle.len);
+
+	return match ? (size_t)(match - view.data) : STR_VIEW_NPOS;
+}
+
+size_t str_view_find_char(StrView view, char c) {
+	const char *match = memchr(view.data, c, view.len);
+
+	return match ? (size_t)(match - view.data) : STR_VIEW_NPOS;
+}
+
+/* Exact-delimiter split */
+void str_split_iter_init(StrSplitIter *iter, StrView text, StrView delim) {
+	iter->pos  = text.data;
+	iter->end  = text.data + text.len;
+	iter->done = false;
+	str_searcher_init(&iter->searcher, delim.data, delim.len);
+}
+
+bool str_split_iter_next(StrSplitIter *iter, StrView *field) {
+	const char *match;
+
+	if (iter->done)
+		return false;
+	match = iter->searcher.len ? str_searcher_find(&iter->searcher, iter->pos, iter->end - iter->pos) : NULL;
+	if (!match) {
+		// Last field runs to the end of the text
+		*field	   = (StrView){iter->pos, (size_t)(iter->end - iter->pos)};
+		iter->done = true;
+		return true;
+	}
+	*field	  = (StrView){iter->pos, (size_t)(match - iter->pos)};
+	iter->pos = match + iter->searcher.len;
+	return true;
+}
+
+/* Delimiter-set tokeniser */
+void str_token_iter_init(StrTokenIter *iter, StrView text, const char *delims) {
+	iter->pos = text.data;
+	iter->end = text.data + text.len;
+	memset(iter->delim, 0, sizeof(iter->delim));
+	while (delims && *delims)
+		iter->delim[(unsigned char)*delims++] = true;
+}
+
+bool str_token_iter_next(StrTokenIter *iter, StrView *token) {
+	const char *start;
+
+	while (iter->pos < iter->end && iter->delim[(unsigned char)*iter->pos])
+		iter->pos++;
+	if (iter->pos == iter->end)
+		return false;
+	start = iter->pos;
+	while (iter->pos < iter->end && !iter->delim[(unsigned char)*iter->pos])
+		iter->pos++;
+	*token = (StrView){start, (size_t)(iter->pos - start)};
+	return true;
+}
@@ -6,22 +6,21 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/31 10:54:54 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/31 12:48:25 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
+#define _POSIX_C_SOURCE 200809L // strnlen
+
 #include "../../includes/lib/strings/strings.h"
+#include "../../includes/lib/strings/string_replace.h"
+#include "../../includes/lib/strings/string_search.h"
+#include "../../includes/lib/strings/string_view.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* Basic string operations */
-size_t str_len(const char *str) {
-	size_t len = 0;
-	while (str && str[len])
-		len++;
-	return len;
-}
-
 size_t str_nlen(const char *str, size_t maxlen) {
 	size_t len = 0;
 	while (str && str[len] && len < maxlen)
@@ -53,16 +52,6 @@ char *str_clone(const char *str) {
 }
 
 /* Comparison functions */
-int str_cmp(const char *s1, const char *s2) {
-	if (!s1 || !s2)
-		return (s1 == s2) ? 0 : (s1 ? 1 : -1);
-	while (*s1 && *s2 && *s1 == *s2) {
-		s1++;
-		s2++;
-	}
-	return *(unsigned char *)s1 - *(unsigned char *)s2;
-}
-
 int str_ncmp(const char *s1, const char *s2, size_t n) {
 	if (!n || !s1 || !s2)
 		return 0;
@@ -73,21 +62,6 @@ int str_ncmp(const char *s1, const char *s2, size_t n) {
 	return *(unsigned char *)s1 - *(unsigned char *)s2;
 }
 
-int str_case_cmp(const char *s1, const char *s2) {
-	unsigned char c1, c2;
-	if (!s1 || !s2)
-		return (s1 == s2) ? 0 : (s1 ? 1 : -1);
-	do {
-		c1 = (*s1 >= 'A' && *s1 <= 'Z') ? *s1 + ('a' - 'A') : *s1;
-		c2 = (*s2 >= 'A' && *s2 <= 'Z') ? *s2 + ('a' - 'A') : *s2;
-		if (!c1)
-			break;
-		s1++;
-		s2++;
-	} while (c1 == c2);
-	return c1 - c2;
-}
-
 bool str_equals(const char *s1, const char *s2) {
 	return str_cmp(s1, s2) == 0;
 }
@@ -177,14 +151,6 @@ size_t str_lcat(char *dest, const char *src, size_t size) {
 }
 
 /* Search functions */
-char *str_chr(const char *str, int c) {
-	if (!str)
-		return NULL;
-	while (*str && *str != (char)c)
-		str++;
-	return (*str == (char)c) ? (char *)str : NULL;
-}
-
 char *str_rchr(const char *str, int c) {
 	const char *last = NULL;
 	if (!str)
@@ -197,30 +163,47 @@ char *str_rchr(const char *str, int c) {
 	return (char *)last;
 }
 
+/*
+ * The haystack is measured and searched in doubling blocks, each one
+ * overlapping the next by needle_len - 1 bytes, so an early match does
+ * not pay for the length of the whole haystack.
+ */
+#define STR_STR_BLOCK 256
+
 char *str_str(const char *haystack, const char *needle) {
-	size_t needle_len;
 	if (!haystack || !needle)
 		return NULL;
 	if (!*needle)
 		return (char *)haystack;
-	needle_len = str_len(needle);
-	while (*haystack) {
-		if (!str_ncmp(haystack, needle, needle_len))
-			return (char *)haystack;
-		haystack++;
+
+	size_t needle_len = str_len(needle);
+	size_t block	  = STR_STR_BLOCK;
+	const char *p	  = str_chr(haystack, *needle);
+	while (p) {
+		size_t avail = strnlen(p, block + needle_len - 1);
+		char *found	 = str_memstr(p, avail, needle, needle_len);
+		if (found || avail < block + needle_len - 1)
+			return found;
+		p += block;
+		block *= 2;
 	}
 	return NULL;
 }
 
 /* Additional Search Functions */
 char *str_rstr(const char *haystack, const char *needle) {
+	StrSearcher searcher;
+	const char *end;
+	char *found;
 	char *last = NULL;
 	if (!haystack || !needle || !*needle)
 		return (char *)haystack;
 
-	while ((haystack = str_str(haystack, needle))) {
-		last = (char *)haystack;
-		haystack++;
+	end = haystack + str_len(haystack);
+	str_searcher_init(&searcher, needle, str_len(needle));
+	while ((found = str_searcher_find(&searcher, haystack, end - haystack))) {
+		last	 = found;
+		haystack = found + 1;
 	}
 	return last;
 }
@@ -240,24 +223,6 @@ char *str_pbrk(const char *str, const char *chars) {
 	return NULL;
 }
 
-size_t str_span(const char *str, const char *accept) {
-	const char *s = str;
-	while (*s) {
-		const char *a = accept;
-		bool found	  = false;
-		while (*a) {
-			if (*s == *a++) {
-				found = true;
-				break;
-			}
-		}
-		if (!found)
-			break;
-		s++;
-	}
-	return s - str;
-}
-
 size_t str_cspan(const char *str, const char *reject) {
 	const char *s = str;
 	while (*s) {
@@ -273,31 +238,6 @@ size_t str_cspan(const char *str, const char *reject) {
 }
 
 /* String manipulation */
-char *str_upper(char *str) {
-	char *s = str;
-	if (!str)
-		return NULL;
-	while (*s) {
-		if (*s >= 'a' && *s <= 'z')
-			*s -= 32;
-		s++;
-	}
-	return str;
-}
-
-char *str_lower(char *str) {
-	char *s = str;
-	if (!str)
-		return NULL;
-	while (*s) {
-		if (*s >= 'A' && *s <= 'Z')
-			*s += 32;
-		s++;
-	}
-	return str;
-}
-
-/* Additional String Manipulation */
 char *str_capitalize(char *str) {
 	if (!str || !*str)
 		return str;
@@ -347,70 +287,33 @@ char *str_trim_right(char *str) {
 	return str;
 }
 
-/* Helper function for str_split */
-static char *str_token(char *str, const char *delim, char **saveptr) {
-	if (!str && !*saveptr)
-		return NULL;
-
-	if (!str)
-		str = *saveptr;
-
-	// Skip leading delimiters
-	str += str_span(str, delim);
-	if (*str == '\0') {
-		*saveptr = str;
-		return NULL;
-	}
-
-	// Find end of token
-	char *token = str;
-	str			= str_pbrk(token, delim);
-	if (str) {
-		*str	 = '\0';
-		*saveptr = str + 1;
-	} else {
-		*saveptr = token + str_len(token);
-	}
-	return token;
-}
-
 char **str_split(const char *str, const char *delim) {
 	if (!str || !delim)
 		return NULL;
 
-	size_t count	= 1;
-	const char *tmp = str;
-	while ((tmp = str_str(tmp, delim))) {
+	// Count first so the array is sized exactly, then copy each token once
+	StrTokenIter iter;
+	StrView token;
+	size_t count = 0;
+	str_token_iter_init(&iter, str_view(str), delim);
+	while (str_token_iter_next(&iter, &token))
 		count++;
-		tmp++;
-	}
 
 	char **result = malloc(sizeof(char *) * (count + 1));
 	if (!result)
 		return NULL;
 
-	char *copy = str_new(str);
-	if (!copy) {
-		free(result);
-		return NULL;
-	}
-
-	size_t i	  = 0;
-	char *saveptr = NULL;
-	char *token	  = str_token(copy, delim, &saveptr);
-
-	while (token) {
-		result[i] = str_new(token);
+	size_t i = 0;
+	str_token_iter_init(&iter, str_view(str), delim);
+	while (str_token_iter_next(&iter, &token)) {
+		result[i] = str_view_dup(token);
 		if (!result[i]) {
 			str_array_free(result);
-			free(copy);
 			return NULL;
 		}
-		token = str_token(NULL, delim, &saveptr);
-		i++;
+		result[++i] = NULL;
 	}
 	result[i] = NULL;
-	free(copy);
 	return result;
 }
 
@@ -447,77 +350,6 @@ char *str_join(const char **strings, const char *delim) {
 	return result;
 }
 
-/* String validation */
-bool str_is_alpha(const char *str) {
-	if (!str)
-		return false;
-	while (*str) {
-		if (!((*str >= 'A' && *str <= 'Z') || (*str >= 'a' && *str <= 'z')))
-			return false;
-		str++;
-	}
-	return true;
-}
-
-bool str_is_digit(const char *str) {
-	if (!str)
-		return false;
-	while (*str) {
-		if (*str < '0' || *str > '9')
-			return false;
-		str++;
-	}
-	return true;
-}
-
-/* Additional String Validation */
-bool str_is_alnum(const char *str) {
-	if (!str)
-		return false;
-	while (*str) {
-		if (!(((*str >= '0') && (*str <= '9')) ||
-			  ((*str >= 'A') && (*str <= 'Z')) ||
-			  ((*str >= 'a') && (*str <= 'z'))))
-			return false;
-		str++;
-	}
-	return true;
-}
-
-bool str_is_space(const char *str) {
-	if (!str)
-		return false;
-	while (*str) {
-		if (*str != ' ' && *str != '\t' && *str != '\n' &&
-			*str != '\r' && *str != '\f' && *str != '\v')
-			return false;
-		str++;
-	}
-	return true;
-}
-
-bool str_is_upper(const char *str) {
-	if (!str)
-		return false;
-	while (*str) {
-		if (*str < 'A' || *str > 'Z')
-			return false;
-		str++;
-	}
-	return true;
-}
-
-bool str_is_lower(const char *str) {
-	if (!str)
-		return false;
-	while (*str) {
-		if (*str < 'a' || *str > 'z')
-			return false;
-		str++;
-	}
-	return true;
-}
-
 /* Memory management */
 void str_array_free(char **array) {
 	if (!array)
@@ -538,71 +370,33 @@ size_t str_array_len(char **array) {
 
 /* Number Conversion Functions */
 long str_to_long(const char *str) {
-	if (!str)
-		return 0;
-	long result = 0;
-	int sign	= 1;
-
-	if (*str == '-') {
-		sign = -1;
-		str++;
-	}
-
-	while (*str >= '0' && *str <= '9') {
-		result = result * 10 + (*str - '0');
-		str++;
-	}
-
-	return result * sign;
+	long value = 0;
+	if (str)
+		str_parse_long(str, str_len(str), &value);
+	return value;
 }
 
 char *long_to_str(long num) {
-	char buffer[32];
-	int i		  = 30;
-	bool negative = num < 0;
-
-	buffer[31] = '\0';
-	if (num == 0) {
-		buffer[i] = '0';
-		return str_new(&buffer[i]);
-	}
-
-	if (negative)
-		num = -num;
+	char buffer[STR_I64_BUFSIZE];
 
-	while (num > 0) {
-		buffer[i--] = '0' + (num % 10);
-		num /= 10;
-	}
-
-	if (negative)
-		buffer[i--] = '-';
-
-	return str_new(&buffer[i + 1]);
+	str_format_long(buffer, num);
+	return str_new(buffer);
 }
 
 char *double_to_str(double num, int precision) {
-	char *result = malloc(32);
+	// Fixed notation can need far more than 32 bytes (1e300)
+	int len = snprintf(NULL, 0, "%.*f", precision, num);
+	if (len < 0)
+		return NULL;
+
+	char *result = malloc((size_t)len + 1);
 	if (!result)
 		return NULL;
 
-	snprintf(result, 32, "%.*f", precision, num);
+	snprintf(result, (size_t)len + 1, "%.*f", precision, num);
 	return result;
 }
 
-int str_count_char(const char *str, char c) {
-	int count = 0;
-	if (!str)
-		return 0;
-
-	while (*str) {
-		if (*str == c)
-			count++;
-		str++;
-	}
-	return count;
-}
-
 char *str_substr(const char *str, size_t start, size_t len) {
 	if (!str)
 		return NULL;
@@ -627,130 +421,34 @@ char *str_replace(const char *str, const char *old, const char *new) {
 	if (!str || !old || !new)
 		return NULL;
 
-	size_t old_len = str_len(old);
-	if (old_len == 0)
-		return str_clone(str);
-
-	// Count occurrences of old string
-	size_t count	= 0;
-	const char *tmp = str;
-	while ((tmp = str_str(tmp, old))) {
-		count++;
-		tmp += old_len;
-	}
-
-	if (count == 0)
-		return str_clone(str);
-
-	// Calculate new string length
-	size_t new_len	   = str_len(new);
-	size_t str_len_val = str_len(str);
-	size_t result_len  = str_len_val + count * (new_len - old_len);
-
-	// Allocate memory for result
-	char *result = malloc(result_len + 1);
-	if (!result)
+	// Single pass into a builder sized for the same-length case
+	StrBuilder out;
+	if (!str_builder_init(&out, str_len(str)))
+		return NULL;
+	if (!str_builder_append_replace(&out, str, old, new)) {
+		str_builder_destroy(&out);
 		return NULL;
-
-	// Build the result string
-	char *dest		= result;
-	const char *src = str;
-	while (*src) {
-		if (str_ncmp(src, old, old_len) == 0) {
-			str_copy(dest, new);
-			src += old_len;
-			dest += new_len;
-		} else {
-			*dest++ = *src++;
-		}
 	}
-	*dest = '\0';
-
-	return result;
+	return str_builder_detach(&out);
 }
 
 int str_to_int(const char *str) {
-	if (!str)
-		return 0;
-
-	int result = 0;
-	int sign   = 1;
-
-	// Handle sign
-	if (*str == '-') {
-		sign = -1;
-		str++;
-	} else if (*str == '+') {
-		str++;
-	}
-
-	// Convert digits
-	while (*str >= '0' && *str <= '9') {
-		result = result * 10 + (*str - '0');
-		str++;
-	}
-
-	return result * sign;
+	int value = 0;
+	if (str)
+		str_parse_int(str, str_len(str), &value);
+	return value;
 }
 
 double str_to_double(const char *str) {
-	if (!str)
-		return 0.0;
-
-	double result	= 0.0;
-	double fraction = 0.0;
-	double power	= 1.0;
-	int sign		= 1;
-
-	// Handle sign
-	if (*str == '-') {
-		sign = -1;
-		str++;
-	} else if (*str == '+') {
-		str++;
-	}
-
-	// Process integer part
-	while (*str >= '0' && *str <= '9') {
-		result = result * 10.0 + (*str - '0');
-		str++;
-	}
-
-	// Process fractional part
-	if (*str == '.') {
-		str++;
-		while (*str >= '0' && *str <= '9') {
-			power *= 10.0;
-			fraction = fraction + (*str - '0') / power;
-			str++;
-		}
-	}
-
-	return sign * (result + fraction);
+	double value = 0.0;
+	if (str)
+		str_parse_double(str, str_len(str), &value);
+	return value;
 }
 
 char *int_to_str(int num) {
-	char buffer[12]; // Enough for 32-bit int including sign and null terminator
-	int i		  = 10;
-	bool negative = num < 0;
-
-	buffer[11] = '\0';
-
-	if (num == 0) {
-		buffer[i] = '0';
-		return str_new(&buffer[i]);
-	}
-
-	if (negative)
-		num = -num;
-
-	while (num > 0) {
-		buffer[i--] = '0' + (num % 10);
-		num /= 10;
-	}
-
-	if (negative)
-		buffer[i--] = '-';
+	char buffer[STR_INT_BUFSIZE];
 
-	return str_new(&buffer[i + 1]);
+	str_format_int(buffer, num);
+	return str_new(buffer);
 }
@@ -0,0 +1,707 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   strings_simd.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../includes/lib/strings/strings.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STR_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#define PAGE_SIZE_MIN 4096
+
+/*
+ * Kernels read whole aligned words/blocks, possibly past the terminator
+ * but never past its page. That is safe, but not for AddressSanitizer.
+ */
+#define STR_KERNEL __attribute__((no_sanitize_address))
+
+/* Byte-replication and zero-byte detection on 64-bit words (SWAR) */
+#define ONES 0x0101010101010101ULL
+#define LOW7 0x7F7F7F7F7F7F7F7FULL
+#define HIGH 0x8080808080808080ULL
+
+/* ASCII character classes as up to three byte ranges; unused slots repeat */
+typedef struct AsciiClass {
+	unsigned char lo[3];
+	unsigned char hi[3];
+} AsciiClass;
+
+static const AsciiClass class_alpha = {{'A', 'a', 'a'}, {'Z', 'z', 'z'}};
+static const AsciiClass class_digit = {{'0', '0', '0'}, {'9', '9', '9'}};
+static const AsciiClass class_alnum = {{'A', 'a', '0'}, {'Z', 'z', '9'}};
+static const AsciiClass class_space = {{'\t', ' ', ' '}, {'\r', ' ', ' '}};
+static const AsciiClass class_upper = {{'A', 'A', 'A'}, {'Z', 'Z', 'Z'}};
+static const AsciiClass class_lower = {{'a', 'a', 'a'}, {'z', 'z', 'z'}};
+
+typedef struct StrKernels {
+	size_t (*len)(const char *str);
+	char *(*chr)(const char *str, int c);
+	int (*cmp)(const char *s1, const char *s2);
+	int (*count_char)(const char *str, char c);
+	size_t (*span)(const char *str, const char *accept);
+	int (*case_cmp)(const char *s1, const char *s2);
+	void (*lower)(char *dest, const char *src, size_t len);
+	void (*upper)(char *dest, const char *src, size_t len);
+	bool (*case_equals)(const char *s1, const char *s2, size_t len);
+	bool (*all_in)(const char *str, size_t len, const AsciiClass *cls);
+} StrKernels;
+
+static StrSimdLevel current_level;
+
+/* An unaligned load of n bytes at p cannot fault if it stays in p's page */
+static inline bool page_safe(const void *p, size_t n) {
+	return ((uintptr_t)p & (PAGE_SIZE_MIN - 1)) <= PAGE_SIZE_MIN - n;
+}
+
+/* Bytes left before the nearer of the two page ends */
+static inline size_t page_room(const void *p1, const void *p2) {
+	size_t r1 = PAGE_SIZE_MIN - ((uintptr_t)p1 & (PAGE_SIZE_MIN - 1));
+	size_t r2 = PAGE_SIZE_MIN - ((uintptr_t)p2 & (PAGE_SIZE_MIN - 1));
+	return (r1 < r2) ? r1 : r2;
+}
+
+/* 0x80 in every byte of w that is zero, exact (no false positives) */
+static inline uint64_t zero_bytes(uint64_t w) {
+	return ~(((w & LOW7) + LOW7) | w | LOW7);
+}
+
+static inline uint64_t load64(const void *p) {
+	uint64_t w;
+	memcpy(&w, p, sizeof(w));
+	return w;
+}
+
+/* Index of the first flagged byte of a zero_bytes() style mask */
+static inline size_t first_byte(uint64_t mask) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	return (size_t)__builtin_ctzll(mask) / 8;
+#else
+	return (size_t)__builtin_clzll(mask) / 8;
+#endif
+}
+
+static void build_set(unsigned char set[256], const char *chars) {
+	memset(set, 0, 256);
+	while (*chars)
+		set[(unsigned char)*chars++] = 1;
+}
+
+/* Portable word-at-a-time kernels */
+STR_KERNEL static size_t len_swar(const char *str) {
+	const char *p = str;
+	uint64_t mask;
+
+	while ((uintptr_t)p & 7) {
+		if (!*p)
+			return p - str;
+		p++;
+	}
+	// Aligned 8-byte loads never cross into the next page
+	while (!(mask = zero_bytes(load64(p))))
+		p += 8;
+	return p + first_byte(mask) - str;
+}
+
+STR_KERNEL static char *chr_swar(const char *str, int c) {
+	uint64_t pattern = ONES * (unsigned char)c;
+	uint64_t w, mask;
+
+	while ((uintptr_t)str & 7) {
+		if (*str == (char)c)
+			return (char *)str;
+		if (!*str)
+			return NULL;
+		str++;
+	}
+	for (;; str += 8) {
+		w	 = load64(str);
+		mask = zero_bytes(w) | zero_bytes(w ^ pattern);
+		if (mask) {
+			str += first_byte(mask);
+			return (*str == (char)c) ? (char *)str : NULL;
+		}
+	}
+}
+
+STR_KERNEL static int cmp_swar(const char *s1, const char *s2) {
+	for (;;) {
+		if (page_safe(s1, 8) && page_safe(s2, 8)) {
+			uint64_t a = load64(s1);
+			if (a == load64(s2) && !zero_bytes(a)) {
+				s1 += 8;
+				s2 += 8;
+				continue;
+			}
+		}
+		// Difference, end of string or page edge within the next 8 bytes
+		for (int i = 0; i < 8; i++, s1++, s2++)
+			if (!*s1 || *s1 != *s2)
+				return *(unsigned char *)s1 - *(unsigned char *)s2;
+	}
+}
+
+STR_KERNEL static int count_char_swar(const char *str, char c) {
+	uint64_t pattern = ONES * (unsigned char)c;
+	int count		 = 0;
+
+	while ((uintptr_t)str & 7) {
+		if (!*str)
+			return count;
+		count += (*str == c);
+		str++;
+	}
+	for (;; str += 8) {
+		uint64_t w	   = load64(str);
+		uint64_t zeros = zero_bytes(w);
+		uint64_t hits  = zero_bytes(w ^ pattern);
+		if (zeros) {
+			// Keep only the hits before the terminator
+			for (size_t i = 0, end = first_byte(zeros); i < end; i++)
+				count += (str[i] == c);
+			return count;
+		}
+		count += __builtin_popcountll(hits);
+	}
+}
+
+static size_t span_table(const char *str, const char *accept) {
+	unsigned char set[256];
+	const unsigned char *s = (const unsigned char *)str;
+
+	// '\0' is never in the set, so the table also stops at the terminator
+	build_set(set, accept);
+	for (;; s += 4) {
+		if (!set[s[0]])
+			return (const char *)s - str;
+		if (!set[s[1]])
+			return (const char *)s + 1 - str;
+		if (!set[s[2]])
+			return (const char *)s + 2 - str;
+		if (!set[s[3]])
+			return (const char *)s + 3 - str;
+	}
+}
+
+/*
+ * 0x80 in every ASCII byte of w within [lo, hi]. Both sums stay below 0x100
+ * on 7-bit bytes, so no carry crosses into the next byte.
+ */
+static inline uint64_t bytes_in_range(uint64_t w, unsigned lo, unsigned hi) {
+	uint64_t h	= w & LOW7;
+	uint64_t ge = h + ONES * (0x80 - lo);
+	uint64_t le = ~(h + ONES * (0x7F - hi));
+	return ge & le & ~w & HIGH;
+}
+
+static inline uint64_t lower64(uint64_t w) {
+	return w | (bytes_in_range(w, 'A', 'Z') >> 2);
+}
+
+static inline uint64_t upper64(uint64_t w) {
+	return w ^ (bytes_in_range(w, 'a', 'z') >> 2);
+}
+
+static inline unsigned char lower8(unsigned char c) {
+	return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static inline bool class_word(uint64_t w, const AsciiClass *cls) {
+	return (bytes_in_range(w, cls->lo[0], cls->hi[0]) | bytes_in_range(w, cls->lo[1], cls->hi[1]) |
+			bytes_in_range(w, cls->lo[2], cls->hi[2])) == HIGH;
+}
+
+STR_KERNEL static int case_cmp_swar(const char *s1, const char *s2) {
+	for (;;) {
+		for (size_t room = page_room(s1, s2); room >= 8; room -= 8, s1 += 8, s2 += 8) {
+			uint64_t a = load64(s1);
+			if (lower64(a) != lower64(load64(s2)) || zero_bytes(a))
+				break;
+		}
+		// Difference, end of string or page edge within the next 8 bytes
+		for (int i = 0; i < 8; i++, s1++, s2++) {
+			unsigned char c1 = lower8(*s1);
+			unsigned char c2 = lower8(*s2);
+			if (!c1 || c1 != c2)
+				return c1 - c2;
+		}
+	}
+}
+
+/*
+ * Length-bounded kernels: whole words, then a last word overlapping the
+ * previous one (case mapping is idempotent, so in place is fine). Inputs
+ * shorter than a word are done a byte at a time.
+ */
+static inline void map_swar(char *dest, const char *src, size_t len, bool upper) {
+	uint64_t w;
+
+	if (len < 8) {
+		for (size_t i = 0; i < len; i++) {
+			unsigned char c = src[i];
+			if (upper)
+				dest[i] = (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+			else
+				dest[i] = lower8(c);
+		}
+		return;
+	}
+	for (size_t i = 0; i < len - 8; i += 8) {
+		w = load64(src + i);
+		w = upper ? upper64(w) : lower64(w);
+		memcpy(dest + i, &w, 8);
+	}
+	w = load64(src + len - 8);
+	w = upper ? upper64(w) : lower64(w);
+	memcpy(dest + len - 8, &w, 8);
+}
+
+static void lower_swar(char *dest, const char *src, size_t len) {
+	map_swar(dest, src, len, false);
+}
+
+static void upper_swar(char *dest, const char *src, size_t len) {
+	map_swar(dest, src, len, true);
+}
+
+static bool case_equals_swar(const char *s1, const char *s2, size_t len) {
+	if (len < 8) {
+		for (size_t i = 0; i < len; i++)
+			if (lower8(s1[i]) != lower8(s2[i]))
+				return false;
+		return true;
+	}
+	for (size_t i = 0; i < len - 8; i += 8)
+		if (lower64(load64(s1 + i)) != lower64(load64(s2 + i)))
+			return false;
+	return lower64(load64(s1 + len - 8)) == lower64(load64(s2 + len - 8));
+}
+
+static bool all_in_swar(const char *str, size_t len, const AsciiClass *cls) {
+	if (len < 8) {
+		for (size_t i = 0; i < len; i++) {
+			unsigned char c = str[i];
+			if (!((c >= cls->lo[0] && c <= cls->hi[0]) || (c >= cls->lo[1] && c <= cls->hi[1]) ||
+				  (c >= cls->lo[2] && c <= cls->hi[2])))
+				return false;
+		}
+		return true;
+	}
+	for (size_t i = 0; i < len - 8; i += 8)
+		if (!class_word(load64(str + i), cls))
+			return false;
+	return class_word(load64(str + len - 8), cls);
+}
+
+static const StrKernels kernels_swar = {
+	len_swar, chr_swar, cmp_swar, count_char_swar, span_table,
+	case_cmp_swar, lower_swar, upper_swar, case_equals_swar, all_in_swar,
+};
+
+/*
+ * Valid before the load-time constructor runs (str_* called from another
+ * constructor); str_simd_init only upgrades it.
+ */
+static const StrKernels *kernels = &kernels_swar;
+
+#ifdef STR_SIMD_X86
+
+/*
+ * SSE2 / AVX2 kernels. Scans load aligned blocks, which never cross a page,
+ * and discard the bytes before the start with a shift of the match mask.
+ */
+#define DEFINE_VECTOR_KERNELS(suffix, ISA, W, vec, LOAD, SET1, CMPEQ, OR, MOVEMASK) \
+	STR_KERNEL __attribute__((target(ISA))) static size_t len_##suffix(const char *str) {     \
+		const vec zero = SET1(0);                                                       \
+		size_t off	   = (uintptr_t)str & (W - 1);                                      \
+		const char *p  = str - off;                                                     \
+		uint32_t mask  = (uint32_t)MOVEMASK(CMPEQ(LOAD((const vec *)p), zero)) >> off;  \
+		if (mask)                                                                       \
+			return __builtin_ctz(mask);                                                 \
+		for (;;) {                                                                      \
+			p += W;                                                                     \
+			mask = MOVEMASK(CMPEQ(LOAD((const vec *)p), zero));                         \
+			if (mask)                                                                   \
+				return p + __builtin_ctz(mask) - str;                                   \
+		}                                                                               \
+	}                                                                                   \
+                                                                                        \
+	STR_KERNEL __attribute__((target(ISA))) static char *chr_##suffix(const char *str, int c) { \
+		const vec zero	= SET1(0);                                                      \
+		const vec needle = SET1((char)c);                                               \
+		size_t off		= (uintptr_t)str & (W - 1);                                     \
+		const char *p	= str - off;                                                    \
+		vec v			= LOAD((const vec *)p);                                         \
+		uint32_t mask	= (uint32_t)MOVEMASK(OR(CMPEQ(v, zero), CMPEQ(v, needle))) >> off; \
+		if (mask)                                                                       \
+			p = str + __builtin_ctz(mask);                                              \
+		else {                                                                          \
+			for (;;) {                                                                  \
+				p += W;                                                                 \
+				v	 = LOAD((const vec *)p);                                            \
+				mask = MOVEMASK(OR(CMPEQ(v, zero), CMPEQ(v, needle)));                  \
+				if (mask) {                                                             \
+					p += __builtin_ctz(mask);                                           \
+					break;                                                              \
+				}                                                                       \
+			}                                                                           \
+		}                                                                               \
+		return (*p == (char)c) ? (char *)p : NULL;                                      \
+	}                                                                                   \
+                                                                                        \
+	STR_KERNEL __attribute__((target(ISA))) static int cmp_##suffix(const char *s1, const char *s2) { \
+		const vec zero = SET1(0);                                                       \
+		for (;;) {                                                                      \
+			if (page_safe(s1, W) && page_safe(s2, W)) {                                 \
+				vec a		  = LOAD##U((const vec *)s1);                                 \
+				vec b		  = LOAD##U((const vec *)s2);                                 \
+				uint32_t diff = ~(uint32_t)MOVEMASK(CMPEQ(a, b));                       \
+				uint32_t stop = (diff | (uint32_t)MOVEMASK(CMPEQ(a, zero)));            \
+				if (W == 16)                                                            \
+					stop &= 0xFFFF;                                                     \
+				if (stop) {                                                             \
+					size_t i = __builtin_ctz(stop);                                     \
+					return (unsigned char)s1[i] - (unsigned char)s2[i];                 \
+				}                                                                       \
+				s1 += W;                                                                \
+				s2 += W;                                                                \
+				continue;                                                               \
+			}                                                                           \
+			for (int i = 0; i < W; i++, s1++, s2++)                                     \
+				if (!*s1 || *s1 != *s2)                                                 \
+					return *(unsigned char *)s1 - *(unsigned char *)s2;                 \
+		}                                                                               \
+	}                                                                                   \
+                                                                                        \
+	STR_KERNEL __attribute__((target(ISA))) static int count_char_##suffix(const char *str, char c) { \
+		const vec zero	= SET1(0);                                                      \
+		const vec needle = SET1(c);                                                     \
+		size_t off		= (uintptr_t)str & (W - 1);                                     \
+		const char *p	= str - off;                                                    \
+		int count		= 0;                                                            \
+		for (;; p += W, off = 0) {                                                      \
+			vec v		   = LOAD((const vec *)p);                                      \
+			uint32_t zeros = (uint32_t)MOVEMASK(CMPEQ(v, zero)) >> off;                 \
+			uint32_t hits  = (uint32_t)MOVEMASK(CMPEQ(v, needle)) >> off;               \
+			if (zeros)                                                                  \
+				return count + __builtin_popcount(hits & ((zeros & -zeros) - 1));       \
+			count += __builtin_popcount(hits);                                          \
+		}                                                                               \
+	}
+
+#define LOAD_SSE2 _mm_load_si128
+#define LOAD_SSE2U _mm_loadu_si128
+#define LOAD_AVX2 _mm256_load_si256
+#define LOAD_AVX2U _mm256_loadu_si256
+
+DEFINE_VECTOR_KERNELS(sse2, "sse2", 16, __m128i, LOAD_SSE2, _mm_set1_epi8, _mm_cmpeq_epi8,
+					  _mm_or_si128, _mm_movemask_epi8)
+DEFINE_VECTOR_KERNELS(avx2, "avx2", 32, __m256i, LOAD_AVX2, _mm256_set1_epi8, _mm256_cmpeq_epi8,
+					  _mm256_or_si256, _mm256_movemask_epi8)
+
+/*
+ * ASCII case and class kernels. A byte range check is one signed compare
+ * after biasing [lo, hi] down to the bottom of the signed range. Inputs
+ * shorter than a vector go to the next narrower kernels (FALLBACK).
+ */
+#define DEFINE_ASCII_KERNELS(suffix, ISA, W, vec, PFX, SI, FALLBACK)                                                                   \
+	__attribute__((target(ISA), always_inline)) static inline vec in_range_##suffix(vec v, int lo, int hi) {                           \
+		vec t = PFX##_add_epi8(v, PFX##_set1_epi8((char)(0x80 - lo)));                                                                 \
+		return PFX##_cmpgt_epi8(PFX##_set1_epi8((char)(0x80 + hi - lo + 1)), t);                                                       \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA), always_inline)) static inline vec lower_vec_##suffix(vec v) {                                          \
+		return PFX##_or_##SI(v, PFX##_and_##SI(in_range_##suffix(v, 'A', 'Z'), PFX##_set1_epi8(0x20)));                                \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA), always_inline)) static inline vec upper_vec_##suffix(vec v) {                                          \
+		return PFX##_xor_##SI(v, PFX##_and_##SI(in_range_##suffix(v, 'a', 'z'), PFX##_set1_epi8(0x20)));                               \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA), always_inline)) static inline void map_##suffix(char *dest, const char *src, size_t len, bool upper) { \
+		vec v;                                                                                                                         \
+		if (len < W) {                                                                                                                 \
+			map_##FALLBACK(dest, src, len, upper);                                                                                     \
+			return;                                                                                                                    \
+		}                                                                                                                              \
+		for (size_t i = 0; i < len - W; i += W) {                                                                                      \
+			v = PFX##_loadu_##SI((const vec *)(src + i));                                                                              \
+			PFX##_storeu_##SI((vec *)(dest + i), upper ? upper_vec_##suffix(v) : lower_vec_##suffix(v));                               \
+		}                                                                                                                              \
+		v = PFX##_loadu_##SI((const vec *)(src + len - W));                                                                            \
+		PFX##_storeu_##SI((vec *)(dest + len - W), upper ? upper_vec_##suffix(v) : lower_vec_##suffix(v));                             \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA))) static void lower_##suffix(char *dest, const char *src, size_t len) {                                 \
+		map_##suffix(dest, src, len, false);                                                                                           \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA))) static void upper_##suffix(char *dest, const char *src, size_t len) {                                 \
+		map_##suffix(dest, src, len, true);                                                                                            \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA), always_inline)) static inline bool case_block_##suffix(const char *s1, const char *s2) {               \
+		vec a = lower_vec_##suffix(PFX##_loadu_##SI((const vec *)s1));                                                                 \
+		vec b = lower_vec_##suffix(PFX##_loadu_##SI((const vec *)s2));                                                                 \
+		return (uint32_t)PFX##_movemask_epi8(PFX##_cmpeq_epi8(a, b)) == (uint32_t)((1ULL << W) - 1);                                   \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA))) static bool case_equals_##suffix(const char *s1, const char *s2, size_t len) {                        \
+		if (len < W)                                                                                                                   \
+			return case_equals_##FALLBACK(s1, s2, len);                                                                                \
+		for (size_t i = 0; i < len - W; i += W)                                                                                        \
+			if (!case_block_##suffix(s1 + i, s2 + i))                                                                                  \
+				return false;                                                                                                          \
+		return case_block_##suffix(s1 + len - W, s2 + len - W);                                                                        \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA), always_inline)) static inline bool class_block_##suffix(const char *str, const AsciiClass *cls) {      \
+		vec v = PFX##_loadu_##SI((const vec *)str);                                                                                    \
+		vec m = PFX##_or_##SI(PFX##_or_##SI(in_range_##suffix(v, cls->lo[0], cls->hi[0]),                                              \
+											in_range_##suffix(v, cls->lo[1], cls->hi[1])),                                             \
+							  in_range_##suffix(v, cls->lo[2], cls->hi[2]));                                                           \
+		return (uint32_t)PFX##_movemask_epi8(m) == (uint32_t)((1ULL << W) - 1);                                                        \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	__attribute__((target(ISA))) static bool all_in_##suffix(const char *str, size_t len, const AsciiClass *cls) {                     \
+		if (len < W)                                                                                                                   \
+			return all_in_##FALLBACK(str, len, cls);                                                                                   \
+		for (size_t i = 0; i < len - W; i += W)                                                                                        \
+			if (!class_block_##suffix(str + i, cls))                                                                                   \
+				return false;                                                                                                          \
+		return class_block_##suffix(str + len - W, cls);                                                                               \
+	}                                                                                                                                  \
+                                                                                                                                       \
+	STR_KERNEL __attribute__((target(ISA))) static int case_cmp_##suffix(const char *s1, const char *s2) {                             \
+		const vec zero = PFX##_setzero_##SI();                                                                                         \
+		for (;;) {                                                                                                                     \
+			for (size_t room = page_room(s1, s2); room >= W; room -= W, s1 += W, s2 += W) {                                            \
+				vec a	   = PFX##_loadu_##SI((const vec *)s1);                                                                        \
+				vec b	   = PFX##_loadu_##SI((const vec *)s2);                                                                        \
+				vec eq	   = PFX##_cmpeq_epi8(lower_vec_##suffix(a), lower_vec_##suffix(b));                                           \
+				uint32_t m = PFX##_movemask_epi8(PFX##_andnot_##SI(PFX##_cmpeq_epi8(a, zero), eq));                                    \
+				if (m != (uint32_t)((1ULL << W) - 1)) {                                                                                \
+					size_t i = __builtin_ctz(~m);                                                                                      \
+					return lower8(s1[i]) - lower8(s2[i]);                                                                              \
+				}                                                                                                                      \
+			}                                                                                                                          \
+			for (int i = 0; i < W; i++, s1++, s2++) {                                                                                  \
+				unsigned char c1 = lower8(*s1);                                                                                        \
+				unsigned char c2 = lower8(*s2);                                                                                        \
+				if (!c1 || c1 != c2)                                                                                                   \
+					return c1 - c2;                                                                                                    \
+			}                                                                                                                          \
+		}                                                                                                                              \
+	}
+
+DEFINE_ASCII_KERNELS(sse2, "sse2", 16, __m128i, _mm, si128, swar)
+DEFINE_ASCII_KERNELS(avx2, "avx2", 32, __m256i, _mm256, si256, sse2)
+
+/*
+ * PCMPISTRI is strspn in one instruction for sets of up to 16 bytes: it
+ * returns the first byte of the block not in the set, or the terminator.
+ */
+STR_KERNEL __attribute__((target("sse4.2"))) static size_t span_sse42(const char *str, const char *accept) {
+	char set_bytes[16] = {0};
+	size_t set_len	   = len_sse2(accept);
+	const char *s	   = str;
+	__m128i set;
+
+	if (set_len == 0 || set_len > 16)
+		return span_table(str, accept);
+	memcpy(set_bytes, accept, set_len);
+	set = _mm_loadu_si128((const __m128i *)set_bytes);
+
+	for (;;) {
+		if (page_safe(s, 16)) {
+			__m128i block = _mm_loadu_si128((const __m128i *)s);
+			int i = _mm_cmpistri(set, block, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_NEGATIVE_POLARITY);
+			if (i < 16)
+				return s + i - str;
+			s += 16;
+			continue;
+		}
+		// Near a page edge: finish the page one byte at a time
+		for (int i = 0; i < 16; i++, s++)
+			if (!*s || !memchr(set_bytes, *s, set_len))
+				return s - str;
+	}
+}
+
+static const StrKernels kernels_sse2 = {
+	len_sse2, chr_sse2, cmp_sse2, count_char_sse2, span_table,
+	case_cmp_sse2, lower_sse2, upper_sse2, case_equals_sse2, all_in_sse2,
+};
+
+static const StrKernels kernels_avx2 = {
+	len_avx2, chr_avx2, cmp_avx2, count_char_avx2, span_sse42,
+	case_cmp_avx2, lower_avx2, upper_avx2, case_equals_avx2, all_in_avx2,
+};
+
+#endif /* STR_SIMD_X86 */
+
+static StrSimdLevel best_level(void) {
+#ifdef STR_SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2"))
+		return STR_SIMD_AVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return STR_SIMD_SSE2;
+#endif
+	return STR_SIMD_SWAR;
+}
+
+StrSimdLevel str_simd_set_level(StrSimdLevel level) {
+	StrSimdLevel best = best_level();
+
+	if (level > best)
+		level = best;
+#ifdef STR_SIMD_X86
+	if (level == STR_SIMD_AVX2)
+		kernels = &kernels_avx2;
+	else if (level == STR_SIMD_SSE2)
+		kernels = &kernels_sse2;
+	else
+#endif
+		kernels = &kernels_swar;
+	current_level = level;
+	return level;
+}
+
+StrSimdLevel str_simd_level(void) {
+	return current_level;
+}
+
+/* Pick the best kernels once, when the library is loaded */
+__attribute__((constructor)) static void str_simd_init(void) {
+	str_simd_set_level(STR_SIMD_AVX2);
+}
+
+/* Dispatched primitives, NULL-tolerant like the rest of the module */
+size_t str_len(const char *str) {
+	return str ? kernels->len(str) : 0;
+}
+
+char *str_chr(const char *str, int c) {
+	return str ? kernels->chr(str, c) : NULL;
+}
+
+int str_cmp(const char *s1, const char *s2) {
+	if (!s1 || !s2)
+		return (s1 == s2) ? 0 : (s1 ? 1 : -1);
+	return kernels->cmp(s1, s2);
+}
+
+int str_count_char(const char *str, char c) {
+	return str ? kernels->count_char(str, c) : 0;
+}
+
+size_t str_span(const char *str, const char *accept) {
+	if (!str || !accept)
+		return 0;
+	return kernels->span(str, accept);
+}
+
+/* ASCII case mapping, case-insensitive comparison and classification */
+int str_case_cmp(const char *s1, const char *s2) {
+	if (!s1 || !s2)
+		return (s1 == s2) ? 0 : (s1 ? 1 : -1);
+	return kernels->case_cmp(s1, s2);
+}
+
+bool str_case_equals(const char *s1, const char *s2) {
+	return str_case_cmp(s1, s2) == 0;
+}
+
+char *str_upper(char *str) {
+	if (str)
+		kernels->upper(str, str, kernels->len(str));
+	return str;
+}
+
+char *str_lower(char *str) {
+	if (str)
+		kernels->lower(str, str, kernels->len(str));
+	return str;
+}
+
+void str_mem_lower(char *dest, const char *src, size_t len) {
+	kernels->lower(dest, src, len);
+}
+
+void str_mem_upper(char *dest, const char *src, size_t len) {
+	kernels->upper(dest, src, len);
+}
+
+bool str_mem_case_equals(const char *s1, const char *s2, size_t len) {
+	return kernels->case_equals(s1, s2, len);
+}
+
+/*
+ * Word-at-a-time hash of the lowercased bytes: each folded word goes
+ * through a 64x64->128 multiply whose halves are xored back together.
+ */
+#define HASH_SEED 0x9E3779B97F4A7C15ULL
+#define HASH_MUL 0xBF58476D1CE4E5B9ULL
+
+static inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+	unsigned __int128 r = (unsigned __int128)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+uint64_t str_mem_case_hash(const char *str, size_t len) {
+	uint64_t h = HASH_SEED ^ len;
+	size_t i   = 0;
+
+	for (; i + 8 <= len; i += 8)
+		h = hash_mix(h ^ lower64(load64(str + i)), HASH_MUL);
+	if (i < len) {
+		uint64_t w = 0;
+		memcpy(&w, str + i, len - i);
+		h = hash_mix(h ^ lower64(w), HASH_MUL);
+	}
+	return hash_mix(h, HASH_SEED);
+}
+
+uint64_t str_case_hash(const char *str) {
+	return str ? str_mem_case_hash(str, kernels->len(str)) : str_mem_case_hash("", 0);
+}
+
+static bool str_is_class(const char *str, const AsciiClass *cls) {
+	return str && kernels->all_in(str, kernels->len(str), cls);
+}
+
+bool str_is_alpha(const char *str) {
+	return str_is_class(str, &class_alpha);
+}
+
+bool str_is_digit(const char *str) {
+	return str_is_class(str, &class_digit);
+}
+
+bool str_is_alnum(const char *str) {
+	return str_is_class(str, &class_alnum);
+}
+
+bool str_is_space(const char *str) {
+	return str_is_class(str, &class_space);
+}
+
+bool str_is_upper(const char *str) {
+	return str_is_class(str, &class_upper);
+}
+
+bool str_is_lower(const char *str) {
+	return str_is_class(str, &class_lower);
+}
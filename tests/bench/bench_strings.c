@@ -0,0 +1,133 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_strings.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <ctype.h>
+#include <hypercore.h>
+#include <lib/strings/strings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+/*
+ * Microbenchmark of the dispatched string primitives against glibc.
+ * Every row reports GB/s over a set of lengths, at each SIMD level.
+ */
+
+#define TOTAL_BYTES (64UL << 20)
+
+static const size_t lengths[] = {7, 16, 64, 256, 4096, 1 << 20};
+static const char *level_names[] = {"swar", "sse2", "avx2"};
+static volatile size_t sink;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef enum { OP_LEN, OP_CHR, OP_CMP, OP_COUNT, OP_SPAN, OP_STR, OP_CASE_CMP, OP_LOWER, OP_ALPHA, OP_COUNT_OPS } Op;
+static const char *op_names[] = {"len", "chr", "cmp", "count_char", "span", "str", "case_cmp", "lower", "is_alpha"};
+
+static size_t count_libc(const char *s, char c) {
+	size_t n = 0;
+	while ((s = strchr(s, c)))
+		n++, s++;
+	return n;
+}
+
+/* ctype loops stand in for the case mapping and classification rows */
+static size_t lower_libc(char *s) {
+	for (char *p = s; *p; p++)
+		*p = tolower((unsigned char)*p);
+	return (size_t)s;
+}
+
+static size_t alpha_libc(const char *s) {
+	while (isalpha((unsigned char)*s))
+		s++;
+	return !*s;
+}
+
+static size_t run(Op op, bool libc, char *a, const char *b) {
+	switch (op) {
+	case OP_LEN:
+		return libc ? strlen(a) : str_len(a);
+	case OP_CHR:
+		return (size_t)(libc ? strchr(a, '#') : str_chr(a, '#'));
+	case OP_CMP:
+		return (size_t)(libc ? strcmp(a, b) : str_cmp(a, b));
+	case OP_COUNT:
+		return libc ? count_libc(a, 'x') : (size_t)str_count_char(a, 'x');
+	case OP_SPAN:
+		return libc ? strspn(a, "abcdefghijklmnopqrstuvwxyz") : str_span(a, "abcdefghijklmnopqrstuvwxyz");
+	case OP_CASE_CMP:
+		return (size_t)(libc ? strcasecmp(a, b) : str_case_cmp(a, b));
+	case OP_LOWER:
+		return libc ? lower_libc(a) : (size_t)str_lower(a);
+	case OP_ALPHA:
+		return libc ? alpha_libc(a) : str_is_alpha(a);
+	default:
+		// Near miss: every prefix of the needle occurs in the text
+		return (size_t)(libc ? strstr(a, "defghijklmz") : str_str(a, "defghijklmz"));
+	}
+}
+
+static double measure(Op op, bool libc, char *a, const char *b, size_t len) {
+	size_t iters = TOTAL_BYTES / (len + 1) + 1;
+	double start = now();
+	for (size_t i = 0; i < iters; i++)
+		sink += run(op, libc, a, b);
+	return (double)iters * len / (now() - start) / 1e9;
+}
+
+int main(void) {
+	size_t max = lengths[sizeof(lengths) / sizeof(*lengths) - 1];
+	char *a	   = malloc(max + 1);
+	char *b	   = malloc(max + 1);
+	StrSimdLevel best = str_simd_level();
+
+	if (!a || !b)
+		return 1;
+	for (size_t i = 0; i < max; i++)
+		a[i] = "abcdefghijklmnopqrstuvwxy"[i % 25];
+	a[max] = '\0';
+	memcpy(b, a, max + 1);
+
+	printf("%-12s %-6s", "op", "impl");
+	for (size_t l = 0; l < sizeof(lengths) / sizeof(*lengths); l++)
+		printf(" %9zu", lengths[l]);
+	printf("   (GB/s)\n");
+
+	for (Op op = OP_LEN; op < OP_COUNT_OPS; op++) {
+		for (int level = -1; level <= (int)best; level++) {
+			if (level >= 0)
+				str_simd_set_level((StrSimdLevel)level);
+			printf("%-12s %-6s", op_names[op], level < 0 ? "glibc" : level_names[level]);
+			for (size_t l = 0; l < sizeof(lengths) / sizeof(*lengths); l++) {
+				size_t len = lengths[l];
+				// Same contents, terminated at len, so every op scans len bytes
+				a[len] = '\0';
+				b[len] = '\0';
+				printf(" %9.2f", measure(op, level < 0, a, b, len));
+				a[len] = "abcdefghijklmnopqrstuvwxy"[len % 25];
+				b[len] = a[len];
+			}
+			printf("\n");
+		}
+	}
+	str_simd_set_level(best);
+	free(a);
+	free(b);
+	return 0;
+}
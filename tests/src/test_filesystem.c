@@ -0,0 +1,181 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   test_filesystem.c                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <assert.h>
+#include <lib/filesystem/filesystem.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char scratch_dir[] = "/tmp/hypercore_fs_XXXXXX";
+
+static const char *scratch_path(const char *name) {
+	static char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s/%s", scratch_dir, name);
+	return path;
+}
+
+// Writes size bytes of a position-dependent pattern
+static void write_pattern(const char *path, size_t size) {
+	t_file *file = fs_open(path, O_WRONLY | O_CREAT | O_TRUNC);
+	assert(file && "fs_open failed");
+
+	unsigned char block[4096];
+	for (size_t done = 0; done < size;) {
+		size_t chunk = (size - done < sizeof(block)) ? size - done : sizeof(block);
+		for (size_t i = 0; i < chunk; i++) {
+			block[i] = (unsigned char)((done + i) * 31 + 7);
+		}
+		assert(fs_write(file, block, (uint32_t)chunk) == (int)chunk);
+		done += chunk;
+	}
+	fs_close(file);
+}
+
+static void test_map_read(void) {
+	printf("Testing read-only mapping...\n");
+	const char *path = scratch_path("read.bin");
+	size_t size		 = 3 * 1024 * 1024 + 123;
+	write_pattern(path, size);
+
+	t_mapping *mapping = fs_map(path, FS_MAP_READ | FS_MAP_SEQUENTIAL | FS_MAP_POPULATE | FS_MAP_HUGE_PAGES);
+	assert(mapping && "fs_map failed");
+	assert(mapping->length == size);
+	const unsigned char *data = mapping->data;
+	for (size_t i = 0; i < size; i++) {
+		assert(data[i] == (unsigned char)(i * 31 + 7));
+	}
+	assert(fs_map_sync(mapping) == FS_SUCCESS);
+	assert(fs_unmap(mapping) == FS_SUCCESS);
+	printf("✓ Read-only mapping test passed\n");
+}
+
+static void test_map_write(void) {
+	printf("Testing read-write mapping...\n");
+	const char *path = scratch_path("write.bin");
+	write_pattern(path, 10000);
+
+	t_mapping *mapping = fs_map(path, FS_MAP_WRITE | FS_MAP_RANDOM);
+	assert(mapping && mapping->length == 10000);
+	unsigned char *data = mapping->data;
+	data[0]				= 'A';
+	data[9999]			= 'Z';
+	assert(fs_map_sync(mapping) == FS_SUCCESS);
+	assert(fs_unmap(mapping) == FS_SUCCESS);
+
+	// Changes reach the file
+	unsigned char buffer[10000];
+	t_file *file = fs_open(path, O_RDONLY);
+	assert(file && fs_read(file, buffer, sizeof(buffer)) == 10000);
+	assert(buffer[0] == 'A' && buffer[9999] == 'Z' && buffer[1] == (unsigned char)(31 + 7));
+	fs_close(file);
+	printf("✓ Read-write mapping test passed\n");
+}
+
+static void test_map_edge_cases(void) {
+	printf("Testing mapping edge cases...\n");
+	const char *path = scratch_path("empty.bin");
+	assert(fs_create(path) == FS_SUCCESS);
+
+	t_mapping *mapping = fs_map(path, FS_MAP_READ);
+	assert(mapping && mapping->data == NULL && mapping->length == 0);
+	assert(fs_unmap(mapping) == FS_SUCCESS);
+
+	assert(fs_map(scratch_path("missing.bin"), FS_MAP_READ) == NULL);
+	assert(fs_map(scratch_dir, FS_MAP_READ) == NULL);
+	assert(fs_map(NULL, FS_MAP_READ) == NULL);
+	assert(fs_unmap(NULL) == FS_ERROR);
+	printf("✓ Mapping edge case test passed\n");
+}
+
+static void test_copy(void) {
+	printf("Testing file copy...\n");
+	char src[PATH_MAX];
+	snprintf(src, sizeof(src), "%s", scratch_path("read.bin"));
+	size_t size = 3 * 1024 * 1024 + 123;
+	assert(fs_set_permissions(src, 0640) == 0);
+
+	assert(fs_copy(src, scratch_path("copy.bin")) == FS_SUCCESS);
+	assert(fs_get_permissions(scratch_path("copy.bin")) == 0640);
+	t_mapping *mapping = fs_map(scratch_path("copy.bin"), FS_MAP_READ);
+	assert(mapping && mapping->length == size);
+	const unsigned char *data = mapping->data;
+	for (size_t i = 0; i < size; i++) {
+		assert(data[i] == (unsigned char)(i * 31 + 7));
+	}
+	assert(fs_unmap(mapping) == FS_SUCCESS);
+
+	// Empty files and files whose size is not known in advance
+	char empty[PATH_MAX];
+	snprintf(empty, sizeof(empty), "%s", scratch_path("empty.bin"));
+	assert(fs_copy(empty, scratch_path("empty_copy.bin")) == FS_SUCCESS);
+	assert(fs_get_size(scratch_path("empty_copy.bin")) == 0);
+	assert(fs_copy("/proc/self/status", scratch_path("status.txt")) == FS_SUCCESS);
+	assert(fs_get_size(scratch_path("status.txt")) > 0);
+
+	assert(fs_copy(src, scratch_path("copy.bin")) == FS_ALREADY_EXISTS);
+	assert(fs_copy(scratch_path("missing.bin"), src) == FS_NOT_FOUND);
+	printf("✓ File copy test passed\n");
+}
+
+static void test_io64(void) {
+	printf("Testing 64-bit sizes and offsets...\n");
+	const char *path = scratch_path("sparse.bin");
+	t_file *file	 = fs_open(path, O_RDWR | O_CREAT | O_TRUNC);
+	assert(file && "fs_open failed");
+
+	assert(fs_write64(file, "head", 4) == 4 && file->offset == 4);
+	// Sparse write past 4 GB: sizes no longer wrap at 32 bits
+	off_t far = ((off_t)5 << 30) + 17;
+	assert(fs_pwrite(file, "tail", 4, far) == 4);
+	assert(file->offset == 4 && file->size == far + 4);
+	assert(fs_get_size64(path) == far + 4);
+
+	char buffer[8] = {0};
+	assert(fs_pread(file, buffer, 4, far) == 4 && memcmp(buffer, "tail", 4) == 0);
+	assert(fs_pread(file, buffer, sizeof(buffer), far + 2) == 2 && memcmp(buffer, "il", 2) == 0);
+	assert(fs_pread(file, buffer, 4, 0) == 4 && memcmp(buffer, "head", 4) == 0);
+	assert(fs_read64(file, buffer, 4) == 4 && buffer[0] == 0 && file->offset == 8);
+	assert(fs_pread(file, buffer, 4, -1) == FS_ERROR);
+	fs_close(file);
+
+	file = fs_open(path, O_RDONLY);
+	assert(file && file->size == far + 4);
+	assert(fs_pwrite(file, "x", 1, 0) == FS_PERMISSION_DENIED);
+	fs_close(file);
+	assert(fs_get_size64(scratch_path("missing.bin")) == FS_ERROR);
+	printf("✓ 64-bit I/O test passed\n");
+}
+
+static void remove_scratch(void) {
+	const char *names[] = {"read.bin",		 "write.bin",  "empty.bin", "copy.bin",
+						   "empty_copy.bin", "status.txt", "sparse.bin"};
+	for (size_t i = 0; i < sizeof(names) / sizeof(*names); i++) {
+		assert(fs_delete(scratch_path(names[i])) == FS_SUCCESS);
+	}
+	assert(fs_remove_directory(scratch_dir) == FS_SUCCESS);
+}
+
+int main(void) {
+	printf("=== Starting Filesystem Tests ===\n\n");
+	assert(mkdtemp(scratch_dir) && "mkdtemp failed");
+
+	test_map_read();
+	test_map_write();
+	test_map_edge_cases();
+	test_copy();
+	test_io64();
+
+	remove_scratch();
+	printf("\n=== All Filesystem Tests Passed ===\n");
+	return 0;
+}
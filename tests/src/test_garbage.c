@@ -6,13 +6,16 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/30 11:27:59 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/30 12:23:03 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include <hypercore.h>
 
 #include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -186,6 +189,412 @@ static void test_oldest_block_management(void) {
 	garbage_cleanup(ctx);
 }
 
+// Pointer index test: many live blocks, frees in scattered order
+static void test_indexed_tracking(void) {
+	print_test_header("Indexed Tracking");
+
+	GarbageContext *ctx = garbage_init(false);
+	assert_not_null(ctx, "Failed to initialize garbage collector");
+
+#define INDEX_COUNT 200000
+	void **ptrs = malloc(INDEX_COUNT * sizeof(void *));
+	assert_not_null(ptrs, "Pointer array allocation failed");
+
+	size_t expected = 0;
+	for (size_t i = 0; i < INDEX_COUNT; i++) {
+		ptrs[i] = gc_malloc(ctx, (i % 64) + 1);
+		assert_not_null(ptrs[i], "Indexed allocation failed");
+		expected += (i % 64) + 1;
+	}
+	assert(ctx->current_allocated_size == expected);
+
+	// Free two thirds, striding through the array so the index gets holes
+	for (size_t i = 0; i < INDEX_COUNT; i++) {
+		size_t idx = (i * 7919) % INDEX_COUNT;
+		if (idx % 3 != 0) {
+			gc_free(ctx, ptrs[idx]);
+			expected -= (idx % 64) + 1;
+			ptrs[idx] = NULL;
+		}
+	}
+	assert(ctx->current_allocated_size == expected);
+	assert(ctx->total_frees == INDEX_COUNT - (INDEX_COUNT + 2) / 3);
+
+	for (size_t i = 0; i < INDEX_COUNT; i++) {
+		if (ptrs[i] != NULL) {
+			MemoryBlock *block = garbage_find_block(ctx, ptrs[i]);
+			assert(block != NULL && block->ptr == ptrs[i] && block->size == (i % 64) + 1);
+		}
+	}
+
+	// Report order is still allocation order
+	MemoryBlock *block = ctx->head;
+	for (size_t i = 0; i < INDEX_COUNT; i += 3, block = block->next) {
+		assert(block != NULL && block->ptr == ptrs[i]);
+	}
+	assert(block == NULL);
+
+	free(ptrs);
+	garbage_cleanup(ctx);
+}
+
+// Embedded-header mode: one allocation per block, no lookup on free
+static void test_embedded_mode(void) {
+	print_test_header("Embedded Mode");
+
+	GarbageContext *ctx = garbage_init_mode(false, GC_MODE_EMBEDDED);
+	assert_not_null(ctx, "Failed to initialize garbage collector");
+	assert(ctx->mode == GC_MODE_EMBEDDED);
+
+	char *text = gc_strdup(ctx, "embedded");
+	int *zeros = gc_calloc(ctx, 16, sizeof(int));
+	double *num = gc_malloc(ctx, sizeof(double));
+	assert_not_null(text, "gc_strdup failed");
+	assert_not_null(zeros, "gc_calloc failed");
+	assert_not_null(num, "gc_malloc failed");
+	assert((uintptr_t)num % _Alignof(max_align_t) == 0);
+	for (int i = 0; i < 16; i++) {
+		assert(zeros[i] == 0);
+	}
+	assert(ctx->total_allocations == 3);
+	assert(ctx->current_allocated_size == 9 + 16 * sizeof(int) + sizeof(double));
+	assert(garbage_find_block(ctx, zeros) != NULL);
+
+	// Growing moves the block to the tail and keeps its contents
+	text = gc_realloc(ctx, text, 4096);
+	assert_not_null(text, "gc_realloc failed");
+	assert(strcmp(text, "embedded") == 0);
+	assert(ctx->tail->ptr == text && ctx->head->ptr == zeros);
+	assert(ctx->current_allocated_size == 4096 + 16 * sizeof(int) + sizeof(double));
+
+	gc_free(ctx, zeros);
+	assert(garbage_find_block(ctx, zeros) == NULL);
+	garbage_free_oldest_block(ctx); // num
+	assert(ctx->head->ptr == text && ctx->head == ctx->tail);
+	assert(ctx->total_frees == 3);
+	assert(gc_realloc(ctx, text, 0) == NULL);
+	assert(ctx->head == NULL && ctx->current_allocated_size == 0);
+
+	// Cleanup releases whatever is still live
+	for (int i = 0; i < 1000; i++) {
+		assert_not_null(gc_malloc(ctx, (size_t)i), "Embedded allocation failed");
+	}
+	assert(ctx->current_allocated_size == 999 * 1000 / 2);
+	garbage_report_usage(ctx);
+
+	garbage_cleanup(ctx);
+	assert(ctx->mode == GC_MODE_EMBEDDED && ctx->head == NULL);
+}
+
+// Arena contexts: bump allocation, nested marks, bulk release
+static void test_arena_context(void) {
+	print_test_header("Arena Context");
+
+	GarbageContext *arena = garbage_arena_create(1024);
+	assert_not_null(arena, "garbage_arena_create failed");
+	assert(arena->mode == GC_MODE_ARENA);
+
+	char *name = gc_strdup(arena, "request");
+	int *zeros = gc_calloc(arena, 8, sizeof(int));
+	void *empty = gc_malloc(arena, 0);
+	assert_not_null(name, "Arena gc_strdup failed");
+	assert_not_null(zeros, "Arena gc_calloc failed");
+	assert(empty != NULL && empty != (void *)zeros);
+	assert((uintptr_t)zeros % _Alignof(max_align_t) == 0);
+	for (int i = 0; i < 8; i++) {
+		assert(zeros[i] == 0);
+	}
+	assert(arena->total_allocations == 3);
+
+	// Nested scopes: the inner rewind keeps the outer scope's blocks
+	GarbageMark outer = garbage_mark(arena);
+	char *kept		  = gc_strdup(arena, "outer scope");
+	GarbageMark inner = garbage_mark(arena);
+	for (int i = 0; i < 100; i++) {
+		char *tmp = gc_malloc(arena, 100);
+		assert_not_null(tmp, "Arena allocation failed");
+		memset(tmp, 'x', 100);
+	}
+	void *large = gc_malloc(arena, 10 * 1024); // Larger than a chunk
+	assert_not_null(large, "Large arena allocation failed");
+	memset(large, 'y', 10 * 1024);
+
+	garbage_rewind(arena, inner);
+	assert(strcmp(kept, "outer scope") == 0 && strcmp(name, "request") == 0);
+	assert(arena->total_allocations - arena->total_frees == 4);
+	assert(arena->current_allocated_size == 8 + 8 * sizeof(int) + 12);
+
+	// Reallocation copies; gc_free leaves the block to the rewind
+	char *grown = gc_realloc(arena, kept, 4000);
+	assert_not_null(grown, "Arena gc_realloc failed");
+	assert(strcmp(grown, "outer scope") == 0);
+	gc_free(arena, grown);
+	assert(strcmp(grown, "outer scope") == 0);
+
+	garbage_rewind(arena, outer);
+	assert(arena->total_allocations - arena->total_frees == 3);
+	assert(strcmp(name, "request") == 0);
+
+	// Rewinding in a loop reuses chunks instead of reallocating them
+	for (int round = 0; round < 1000; round++) {
+		GarbageMark mark = garbage_mark(arena);
+		for (int i = 0; i < 50; i++) {
+			assert_not_null(gc_strdup(arena, "per request data"), "Arena gc_strdup failed");
+		}
+		garbage_rewind(arena, mark);
+	}
+	garbage_report_usage(arena);
+
+	garbage_cleanup(arena);
+	assert(arena->chunks == NULL && arena->total_allocations == 0);
+	assert_not_null(gc_malloc(arena, 16), "Arena reuse after cleanup failed");
+	garbage_arena_destroy(arena);
+}
+
+// Returns the line of a profile dump starting with prefix, or NULL
+static const char *find_dump_line(const char *dump, const char *prefix) {
+	size_t prefix_len = strlen(prefix);
+
+	for (const char *line = dump; line != NULL && *line != '\0'; line = strchr(line, '\n')) {
+		line += (*line == '\n');
+		if (strncmp(line, prefix, prefix_len) == 0) {
+			return line;
+		}
+	}
+	return NULL;
+}
+
+static void test_profile(void) {
+	print_test_header("Allocation Profile");
+
+	GarbageContext *ctx = garbage_init(false);
+	void *early			= gc_malloc(ctx, 8); // Not profiled
+	assert(garbage_profile_enable(ctx));
+
+	const char *previous = garbage_profile_tag("parser");
+	assert(previous == NULL);
+	void *tokens[100];
+	for (int i = 0; i < 100; i++) {
+		tokens[i] = gc_malloc(ctx, 24);
+		assert_not_null(tokens[i], "Tagged allocation failed");
+	}
+	assert(garbage_profile_tag(previous) != NULL);
+	for (int i = 0; i < 30; i++) {
+		gc_free(ctx, tokens[i]);
+	}
+
+	void *pages[10];
+	for (int i = 0; i < 10; i++) {
+		pages[i] = gc_calloc(ctx, 1, 4000);
+		assert_not_null(pages[i], "Untagged allocation failed");
+	}
+	for (int i = 0; i < 10; i++) {
+		gc_free(ctx, pages[i]);
+	}
+	gc_free(ctx, early);
+
+	// Enough allocations for a couple of rate samples
+	for (int i = 0; i < 2 * GC_PROFILE_RATE_STRIDE; i++) {
+		gc_free(ctx, gc_strdup(ctx, "x"));
+	}
+
+	char *dump = NULL;
+	size_t len = 0;
+	FILE *out  = open_memstream(&dump, &len);
+	assert(out != NULL && garbage_profile_dump(ctx, out));
+	fclose(out);
+
+	size_t allocations, frees, bytes, live, peak;
+	assert(strncmp(dump, "gcprof 1\n", 9) == 0);
+	assert(sscanf(find_dump_line(dump, "total "), "total %zu %zu %zu %zu %zu", &allocations, &frees, &bytes, &live, &peak) == 5);
+	assert(allocations == 110 + 2 * GC_PROFILE_RATE_STRIDE);
+	assert(frees == 40 + 2 * GC_PROFILE_RATE_STRIDE);
+	assert(live == 70 * 24);
+	assert(peak == 70 * 24 + 10 * 4000);
+
+	// 24-byte blocks land in the 16..31 class, 4000 in 2048..4095
+	assert(sscanf(find_dump_line(dump, "class 31 "), "class 31 %zu %zu %zu %zu", &allocations, &frees, &bytes, &live) == 4);
+	assert(allocations == 100 && frees == 30 && bytes == 2400 && live == 1680);
+	assert(find_dump_line(dump, "class 4095 100 ") == NULL);
+	assert(find_dump_line(dump, "class 4095 10 10 40000 0") != NULL);
+
+	assert(sscanf(find_dump_line(dump, "tag parser "), "tag parser %zu %zu %zu %zu", &allocations, &frees, &bytes, &live) == 4);
+	assert(allocations == 100 && frees == 30 && live == 1680);
+	assert(find_dump_line(dump, "site 0x") != NULL);
+	assert(find_dump_line(dump, "rate ") != NULL);
+	free(dump);
+
+	GarbageContext *arena = garbage_arena_create(0);
+	assert(!garbage_profile_enable(arena) && !garbage_profile_dump(arena, stdout));
+	garbage_arena_destroy(arena);
+
+	garbage_cleanup(ctx);
+	assert(ctx->profile == NULL);
+}
+
+// Whether estimate is within tolerance (a fraction) of expected
+static bool roughly(size_t estimate, size_t expected, double tolerance) {
+	double error = ((double)estimate - (double)expected) / (double)expected;
+	return error < tolerance && error > -tolerance;
+}
+
+static void test_sampled_mode(void) {
+	print_test_header("Sampled Mode");
+
+	GarbageContext *ctx = garbage_init_sampled(false, 4096);
+	assert(ctx->mode == GC_MODE_SAMPLED && ctx->sample_period == 4096);
+	// A fixed seed keeps the statistical checks below reproducible
+	garbage_sample_seed(ctx, 42);
+
+	// About 1.5% of the 64-byte blocks are recorded, every 1 MiB block is
+	static char *small[20000];
+	void *large[10];
+	for (int i = 0; i < 20000; i++) {
+		small[i] = gc_malloc(ctx, 64);
+		assert_not_null(small[i], "Sampled gc_malloc failed");
+		small[i][63] = 'x';
+	}
+	for (int i = 0; i < 10; i++) {
+		large[i] = gc_malloc(ctx, 1024 * 1024);
+		assert_not_null(large[i], "Sampled gc_malloc failed");
+		assert(garbage_find_block(ctx, large[i]) != NULL);
+	}
+	assert(ctx->total_allocations > 10 && ctx->total_allocations < 1000);
+
+	size_t blocks, bytes;
+	garbage_estimate_live(ctx, &blocks, &bytes);
+	assert(roughly(blocks, 20010, 0.3));
+	assert(roughly(bytes, 20000 * 64 + 10 * 1024 * 1024, 0.05));
+
+	// Unrecorded blocks are freed and reallocated without errors
+	for (int i = 0; i < 20000; i += 2) {
+		gc_free(ctx, small[i]);
+	}
+	for (int i = 1; i < 20000; i += 4) {
+		small[i] = gc_realloc(ctx, small[i], 96);
+		assert(small[i] != NULL && small[i][63] == 'x');
+	}
+	garbage_estimate_live(ctx, &blocks, &bytes);
+	assert(roughly(blocks, 10010, 0.3));
+	for (int i = 1; i < 20000; i += 2) {
+		gc_free(ctx, small[i]);
+	}
+	garbage_report_usage(ctx);
+
+	for (int i = 0; i < 10; i++) {
+		gc_free(ctx, large[i]);
+	}
+	garbage_estimate_live(ctx, &blocks, &bytes);
+	assert(blocks == 0 && bytes == 0 && ctx->head == NULL);
+	assert(ctx->total_allocations == ctx->total_frees);
+
+	assert(garbage_shared_create(false, GC_MODE_SAMPLED) == NULL);
+	garbage_cleanup(ctx);
+}
+
+#define SHARED_THREADS 8
+#define SHARED_BLOCKS 20000
+
+typedef struct SharedWork {
+	GarbageContext *ctx;
+	char **blocks; /**< SHARED_BLOCKS slots */
+	int id;
+} SharedWork;
+
+// Allocates every block and frees the even ones from the same thread
+static void *shared_allocate(void *arg) {
+	SharedWork *work = arg;
+
+	for (int i = 0; i < SHARED_BLOCKS; i++) {
+		work->blocks[i] = gc_malloc(work->ctx, 16 + i % 64);
+		assert(work->blocks[i] != NULL);
+		work->blocks[i][0] = (char)work->id;
+	}
+	for (int i = 0; i < SHARED_BLOCKS; i += 2) {
+		gc_free(work->ctx, work->blocks[i]);
+	}
+	return NULL;
+}
+
+// Grows then frees the odd blocks another thread allocated
+static void *shared_release(void *arg) {
+	SharedWork *work = arg;
+
+	for (int i = 1; i < SHARED_BLOCKS; i += 2) {
+		char *grown = gc_realloc(work->ctx, work->blocks[i], 128);
+		assert(grown != NULL && grown[0] == (char)work->id);
+		gc_free(work->ctx, grown);
+	}
+	return NULL;
+}
+
+static void run_shared_context(GarbageMode mode) {
+	GarbageContext *ctx = garbage_shared_create(false, mode);
+	assert_not_null(ctx, "garbage_shared_create failed");
+	assert(garbage_profile_enable(ctx));
+
+	pthread_t threads[SHARED_THREADS];
+	SharedWork work[SHARED_THREADS];
+	for (int t = 0; t < SHARED_THREADS; t++) {
+		work[t] = (SharedWork){ctx, malloc(SHARED_BLOCKS * sizeof(char *)), t};
+		assert_not_null(work[t].blocks, "Slot allocation failed");
+		assert(pthread_create(&threads[t], NULL, shared_allocate, &work[t]) == 0);
+	}
+	for (int t = 0; t < SHARED_THREADS; t++) {
+		pthread_join(threads[t], NULL);
+	}
+
+	garbage_merge_stats(ctx);
+	assert(ctx->total_allocations == SHARED_THREADS * SHARED_BLOCKS);
+	assert(ctx->total_frees == SHARED_THREADS * SHARED_BLOCKS / 2);
+	assert(garbage_find_block(ctx, work[3].blocks[1]) != NULL);
+	assert(garbage_find_block(ctx, work[3].blocks[0]) == NULL);
+
+	// Each thread releases blocks allocated by another (now exited) thread
+	for (int t = 0; t < SHARED_THREADS; t++) {
+		assert(pthread_create(&threads[t], NULL, shared_release, &work[(t + 1) % SHARED_THREADS]) == 0);
+	}
+	for (int t = 0; t < SHARED_THREADS; t++) {
+		pthread_join(threads[t], NULL);
+	}
+
+	garbage_merge_stats(ctx);
+	assert(ctx->total_allocations - ctx->total_frees == 0);
+	assert(ctx->current_allocated_size == 0);
+
+	// Profile counters agree with the merged statistics
+	char *dump	= NULL;
+	size_t len	= 0;
+	FILE *out	= open_memstream(&dump, &len);
+	size_t allocations, frees, bytes, live, peak;
+	assert(out != NULL && garbage_profile_dump(ctx, out));
+	fclose(out);
+	assert(sscanf(dump, "gcprof 1\ntotal %zu %zu %zu %zu %zu", &allocations, &frees, &bytes, &live, &peak) == 5);
+	assert(allocations == ctx->total_allocations && frees == ctx->total_frees && live == 0);
+	assert(peak > 0 && peak <= bytes);
+	free(dump);
+
+	// Blocks still live at destroy time are released with the caches
+	for (int i = 0; i < 100; i++) {
+		assert_not_null(gc_strdup(ctx, "left behind"), "Shared gc_strdup failed");
+	}
+	garbage_merge_stats(ctx);
+	assert(ctx->total_allocations - ctx->total_frees == 100);
+
+	for (int t = 0; t < SHARED_THREADS; t++) {
+		free(work[t].blocks);
+	}
+	garbage_shared_destroy(ctx);
+}
+
+static void test_shared_context(void) {
+	print_test_header("Shared Context");
+
+	run_shared_context(GC_MODE_INDEXED);
+	run_shared_context(GC_MODE_EMBEDDED);
+	assert(garbage_shared_create(false, GC_MODE_ARENA) == NULL);
+}
+
 int main(void) {
 	// Run all tests independently
 	test_basic_allocations();
@@ -193,6 +602,12 @@ int main(void) {
 	test_stress();
 	test_edge_cases();
 	test_oldest_block_management();
+	test_indexed_tracking();
+	test_embedded_mode();
+	test_arena_context();
+	test_shared_context();
+	test_profile();
+	test_sampled_mode();
 
 	printf("\n=== All tests completed successfully ===\n");
 	return 0;
@@ -0,0 +1,256 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   test_pool.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <assert.h>
+#include <hypercore.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define THREAD_COUNT 4
+#define THREAD_OPS 200000
+
+static unsigned int int_hash(const void *key) {
+	return (unsigned int)*(const int *)key * 2654435761u;
+}
+
+static int int_compare(const void *a, const void *b) {
+	int x = *(const int *)a;
+	int y = *(const int *)b;
+	return (x > y) - (x < y);
+}
+
+static void test_size_classes(void) {
+	printf("Testing size classes and reuse...\n");
+	ObjectPool pool;
+	assert(pool_init(&pool, false));
+
+	for (size_t size = 1; size <= POOL_MAX_SIZE; size++) {
+		char *ptr = pool_alloc(&pool, size);
+		assert(ptr && "Pool allocation failed");
+		assert((uintptr_t)ptr % POOL_ALIGN == 0);
+		memset(ptr, 0xAB, size);
+		pool_free(&pool, ptr, size);
+	}
+
+	// A freed object is handed back to the next request of its class
+	void *first = pool_alloc(&pool, 40);
+	pool_free(&pool, first, 40);
+	void *second = pool_alloc(&pool, 48);
+	assert(first == second);
+	pool_free(&pool, second, 48);
+
+	// Distinct live objects never overlap
+	char *objects[1000];
+	for (int i = 0; i < 1000; i++) {
+		objects[i] = pool_alloc(&pool, 24);
+		assert(objects[i]);
+		memset(objects[i], i & 0xFF, 24);
+	}
+	for (int i = 0; i < 1000; i++) {
+		for (int j = 0; j < 24; j++) {
+			assert((unsigned char)objects[i][j] == (i & 0xFF));
+		}
+		pool_free(&pool, objects[i], 24);
+	}
+
+	pool_free(&pool, NULL, 24);
+	pool_destroy(&pool);
+	printf("✓ Size class test passed\n");
+}
+
+static void test_large_objects(void) {
+	printf("Testing large objects...\n");
+	ObjectPool pool;
+	assert(pool_init(&pool, false));
+
+	char *ptr = pool_alloc(&pool, POOL_MAX_SIZE + 1);
+	assert(ptr);
+	memset(ptr, 0, POOL_MAX_SIZE + 1);
+	pool_free(&pool, ptr, POOL_MAX_SIZE + 1);
+
+	ptr = pool_alloc(&pool, 1 << 20);
+	assert(ptr);
+	memset(ptr, 0, 1 << 20);
+	pool_free(&pool, ptr, 1 << 20);
+
+	pool_destroy(&pool);
+	printf("✓ Large object test passed\n");
+}
+
+static void test_containers(void) {
+	printf("Testing containers on a pool...\n");
+	ObjectPool pool;
+	assert(pool_init(&pool, false));
+	Allocator allocator = pool_allocator(&pool);
+
+	List list;
+	assert(list_init_with_allocator(&list, allocator) == 0);
+	for (int i = 0; i < 1000; i++) {
+		assert(list_push_back(&list, &i, sizeof(int)) == 0);
+	}
+	assert(list_size(&list) == 1000);
+	assert(*(int *)list_get(&list, 500) == 500);
+	for (int i = 0; i < 500; i++) {
+		assert(list_pop_front(&list) == 0);
+	}
+	assert(*(int *)list_front(&list) == 500);
+	list_destroy(&list);
+
+	RBTree rb;
+	AVLTree avl;
+	Map map;
+	assert(rb_tree_init_with_allocator(&rb, sizeof(int), int_compare, allocator) == 0);
+	assert(avl_tree_init_with_allocator(&avl, sizeof(int), int_compare, allocator) == 0);
+	assert(map_init_with_allocator(&map, 16, sizeof(int), map_hash_int, map_compare_int, allocator) == 0);
+	for (int i = 0; i < 1000; i++) {
+		int value = i * 2;
+		assert(rb_tree_insert(&rb, &i, &value, sizeof(int)) == 0);
+		assert(avl_tree_insert(&avl, &i, &value, sizeof(int)) == 0);
+		assert(map_insert(&map, &i, &value, sizeof(int)) == 0);
+	}
+	for (int i = 0; i < 1000; i += 2) {
+		assert(rb_tree_remove(&rb, &i) == 0);
+		assert(map_erase(&map, &i) == 0);
+	}
+	for (int i = 1; i < 1000; i += 2) {
+		assert(*(int *)rb_tree_find(&rb, &i) == i * 2);
+		assert(*(int *)avl_tree_find(&avl, &i) == i * 2);
+		assert(*(int *)map_get(&map, &i) == i * 2);
+	}
+	rb_tree_destroy(&rb);
+	avl_tree_destroy(&avl);
+	map_destroy(&map);
+
+	SkipList *skip = skip_list_create_with_allocator(allocator);
+	assert(skip);
+	static int values[1000];
+	for (int i = 0; i < 1000; i++) {
+		values[i] = i;
+		assert(skip_list_insert(skip, i, &values[i]) == 1);
+	}
+	for (int i = 0; i < 1000; i += 3) {
+		assert(skip_list_delete(skip, i) == 1);
+	}
+	assert(skip_list_search(skip, 1)->value == &values[1]);
+	assert(!skip_list_search(skip, 3));
+	skip_list_destroy(skip);
+
+	HashTable table;
+	assert(hash_table_init_with_allocator(&table, 16, sizeof(int), int_hash, int_compare, allocator));
+	for (int i = 0; i < 1000; i++) {
+		assert(hash_table_insert(&table, &i, &i, sizeof(int)));
+	}
+	for (int i = 0; i < 1000; i++) {
+		assert(*(int *)hash_table_find(&table, &i) == i);
+	}
+	hash_table_destroy(&table);
+
+	pool_destroy(&pool);
+	printf("✓ Container test passed\n");
+}
+
+static void *thread_worker(void *arg) {
+	ObjectPool *pool = arg;
+	void *live[64]	 = {0};
+	size_t sizes[64] = {0};
+	unsigned int seed = (unsigned int)(uintptr_t)&live;
+
+	for (int i = 0; i < THREAD_OPS; i++) {
+		seed	   = seed * 1103515245u + 12345u;
+		size_t idx = (seed >> 16) % 64;
+		if (live[idx]) {
+			assert(*(size_t *)live[idx] == sizes[idx]);
+			pool_free(pool, live[idx], sizes[idx]);
+			live[idx] = NULL;
+		} else {
+			sizes[idx] = sizeof(size_t) + (seed >> 8) % (POOL_MAX_SIZE - sizeof(size_t));
+			live[idx]  = pool_alloc(pool, sizes[idx]);
+			assert(live[idx]);
+			*(size_t *)live[idx] = sizes[idx];
+		}
+	}
+	for (int i = 0; i < 64; i++) {
+		pool_free(pool, live[i], sizes[i]);
+	}
+	return NULL;
+}
+
+static void test_thread_cache(void) {
+	printf("Testing shared pool with thread caches...\n");
+	ObjectPool pool;
+	assert(pool_init(&pool, true));
+
+	pthread_t threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		assert(pthread_create(&threads[i], NULL, thread_worker, &pool) == 0);
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	// The main thread gets its own cache and can still use the pool
+	void *ptr = pool_alloc(&pool, 64);
+	assert(ptr);
+	pool_free(&pool, ptr, 64);
+
+	pool_destroy(&pool);
+	printf("✓ Thread cache test passed\n");
+}
+
+static double elapsed(struct timespec start, struct timespec end) {
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+static void test_performance(void) {
+	printf("Testing performance...\n");
+	const int count = 1000000;
+	struct timespec start, end;
+
+	List list;
+	list_init(&list);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < count; i++) {
+		list_push_back(&list, &i, sizeof(int));
+	}
+	list_destroy(&list);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printf("  malloc nodes: %.3f s\n", elapsed(start, end));
+
+	ObjectPool pool;
+	assert(pool_init(&pool, false));
+	list_init_with_allocator(&list, pool_allocator(&pool));
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < count; i++) {
+		list_push_back(&list, &i, sizeof(int));
+	}
+	list_destroy(&list);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printf("  pooled nodes: %.3f s\n", elapsed(start, end));
+	pool_destroy(&pool);
+	printf("✓ Performance test completed\n");
+}
+
+int main(void) {
+	printf("=== Starting Object Pool Tests ===\n\n");
+
+	test_size_classes();
+	test_large_objects();
+	test_containers();
+	test_thread_cache();
+	test_performance();
+
+	printf("\n=== All Object Pool Tests Passed ===\n");
+	return 0;
+}
@@ -0,0 +1,382 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   test_sort.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:00:00 by vvaucoul          #+#    #+#             */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <assert.h>
+#include <hypercore.h>
+#include <limits.h>
+#include <lib/sort/sort.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Test helper functions */
+#define TEST_START(name) printf("Testing %s...\n", name)
+#define TEST_END(name) printf("%s: OK\n", name)
+#define ASSERT(condition) assert(condition)
+
+typedef struct {
+	int key;
+	size_t seq;
+} Record;
+
+static int compare_record(const void *a, const void *b) {
+	const Record *ra = a;
+	const Record *rb = b;
+	return (ra->key > rb->key) - (ra->key < rb->key);
+}
+
+// Reference comparator, safe for INT_MIN / INT_MAX
+static int compare_int_safe(const void *a, const void *b) {
+	int va = *(const int *)a;
+	int vb = *(const int *)b;
+	return (va > vb) - (va < vb);
+}
+
+static int *random_ints(size_t n, int range) {
+	int *array = malloc(n * sizeof(int));
+	for (size_t i = 0; i < n; i++)
+		array[i] = (rand() % range) - range / 2;
+	return array;
+}
+
+static void assert_sorted_copy(const int *sorted, const int *original, size_t n) {
+	int *expected = malloc(n * sizeof(int));
+	memcpy(expected, original, n * sizeof(int));
+	qsort(expected, n, sizeof(int), compare_int_safe);
+	ASSERT(memcmp(expected, sorted, n * sizeof(int)) == 0);
+	free(expected);
+}
+
+/* Parallel sort tests */
+static void test_parallel_sort(void) {
+	TEST_START("Parallel Sort");
+
+	size_t sizes[]	 = {0, 1, 2, 17, 1000, 100000, 1000003};
+	size_t threads[] = {0, 1, 2, 3, 4, 7, 8};
+
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+		for (size_t t = 0; t < sizeof(threads) / sizeof(*threads); t++) {
+			int *original = random_ints(sizes[s] ? sizes[s] : 1, 1000000);
+			int *array	  = malloc((sizes[s] ? sizes[s] : 1) * sizeof(int));
+			memcpy(array, original, sizes[s] * sizeof(int));
+			parallel_sort_threads(array, sizes[s], sizeof(int), compare_int, threads[t]);
+			assert_sorted_copy(array, original, sizes[s]);
+			free(original);
+			free(array);
+		}
+	}
+
+	// Default thread count setting
+	parallel_sort_set_threads(5);
+	ASSERT(parallel_sort_get_threads() == 5);
+	int *original = random_ints(200000, 100);
+	int *array	  = malloc(200000 * sizeof(int));
+	memcpy(array, original, 200000 * sizeof(int));
+	parallel_sort(array, 200000, sizeof(int), compare_int);
+	assert_sorted_copy(array, original, 200000);
+	parallel_sort_set_threads(0);
+	free(original);
+	free(array);
+
+	// Stability across chunk boundaries
+	size_t n		= 300000;
+	Record *records = malloc(n * sizeof(Record));
+	for (size_t i = 0; i < n; i++) {
+		records[i].key = rand() % 50;
+		records[i].seq = i;
+	}
+	parallel_sort_threads(records, n, sizeof(Record), compare_record, 6);
+	for (size_t i = 1; i < n; i++) {
+		ASSERT(records[i - 1].key <= records[i].key);
+		if (records[i - 1].key == records[i].key)
+			ASSERT(records[i - 1].seq < records[i].seq);
+	}
+	free(records);
+
+	TEST_END("Parallel Sort");
+}
+
+static uint64_t record_key(const void *elem) {
+	return (uint64_t)((const Record *)elem)->key;
+}
+
+/* Type-specialised sort tests */
+static void test_typed_sort(void) {
+	TEST_START("Typed Sort");
+
+	// Random, sorted, reversed and all-equal inputs
+	size_t n	  = 100000;
+	int *original = random_ints(n, 1000000);
+	int *array	  = malloc(n * sizeof(int));
+	original[0]	  = INT_MIN;
+	original[1]	  = INT_MAX;
+	memcpy(array, original, n * sizeof(int));
+	sort_int(array, n);
+	ASSERT(array[0] == INT_MIN && array[n - 1] == INT_MAX);
+	assert_sorted_copy(array, original, n);
+	sort_int(array, n);
+	assert_sorted_copy(array, original, n);
+	for (size_t i = 0; i < n / 2; i++) {
+		int tmp			  = array[i];
+		array[i]		  = array[n - 1 - i];
+		array[n - 1 - i] = tmp;
+	}
+	sort_int(array, n);
+	assert_sorted_copy(array, original, n);
+	for (size_t i = 0; i < n; i++)
+		array[i] = 7;
+	sort_int(array, n);
+	ASSERT(array[0] == 7 && array[n - 1] == 7);
+
+	// Existing entry points pick the kernel up through the comparator
+	memcpy(array, original, n * sizeof(int));
+	quick_sort(array, n, sizeof(int), compare_int);
+	assert_sorted_copy(array, original, n);
+	memcpy(array, original, n * sizeof(int));
+	merge_sort(array, n, sizeof(int), compare_int);
+	assert_sorted_copy(array, original, n);
+	ASSERT(sort_typed(array, n, sizeof(int), compare_int));
+	ASSERT(!sort_typed(array, n, sizeof(int), compare_record));
+	ASSERT(!sort_typed(array, n, sizeof(long), compare_int));
+	free(original);
+	free(array);
+
+	// 64-bit and floating point kernels
+	uint64_t u64[1000];
+	for (size_t i = 0; i < 1000; i++)
+		u64[i] = ((uint64_t)rand() << 40) ^ (uint64_t)rand();
+	sort_u64(u64, 1000);
+	for (size_t i = 1; i < 1000; i++)
+		ASSERT(u64[i - 1] <= u64[i]);
+
+	double doubles[1000];
+	for (size_t i = 0; i < 1000; i++)
+		doubles[i] = (rand() - RAND_MAX / 2) / 7.0;
+	quick_sort(doubles, 1000, sizeof(double), compare_double);
+	for (size_t i = 1; i < 1000; i++)
+		ASSERT(doubles[i - 1] <= doubles[i]);
+
+	// sort_by_key is stable
+	Record *records = malloc(n * sizeof(Record));
+	for (size_t i = 0; i < n; i++) {
+		records[i].key = rand() % 100;
+		records[i].seq = i;
+	}
+	sort_by_key(records, n, sizeof(Record), record_key);
+	for (size_t i = 1; i < n; i++) {
+		ASSERT(records[i - 1].key <= records[i].key);
+		if (records[i - 1].key == records[i].key)
+			ASSERT(records[i - 1].seq < records[i].seq);
+	}
+	free(records);
+
+	TEST_END("Typed Sort");
+}
+
+/* Sorting network tests */
+static void test_sort_network(void) {
+	TEST_START("Sort Network");
+
+	int32_t i32[SORT_NETWORK_MAX + 8];
+	uint32_t u32[SORT_NETWORK_MAX + 8];
+	int64_t i64[SORT_NETWORK_MAX + 8];
+	uint64_t u64[SORT_NETWORK_MAX + 8];
+
+	for (int round = 0; round < 200; round++) {
+		for (size_t n = 0; n <= SORT_NETWORK_MAX + 8; n++) {
+			for (size_t i = 0; i < n; i++) {
+				i32[i] = (int32_t)((uint32_t)rand() * 2654435761u);
+				u32[i] = (uint32_t)rand() * 2654435761u;
+				i64[i] = (int64_t)(((uint64_t)rand() << 33) ^ ((uint64_t)rand() * 2654435761u));
+				u64[i] = ((uint64_t)rand() << 33) ^ (uint64_t)rand();
+			}
+			if (n > 2) {
+				i32[0] = INT32_MIN;
+				i32[1] = INT32_MAX;
+				u32[0] = UINT32_MAX;
+				i64[0] = INT64_MIN;
+				i64[1] = INT64_MAX;
+				u64[0] = UINT64_MAX;
+			}
+			sort_network_i32(i32, n);
+			sort_network_u32(u32, n);
+			sort_network_i64(i64, n);
+			sort_network_u64(u64, n);
+			for (size_t i = 1; i < n; i++) {
+				ASSERT(i32[i - 1] <= i32[i]);
+				ASSERT(u32[i - 1] <= u32[i]);
+				ASSERT(i64[i - 1] <= i64[i]);
+				ASSERT(u64[i - 1] <= u64[i]);
+			}
+		}
+	}
+
+	// Zero-one principle: every 0/1 input of one full network block
+	for (uint32_t bits = 0; bits < (1u << 16); bits++) {
+		size_t ones = 0;
+		for (size_t i = 0; i < 16; i++) {
+			i32[i] = (bits >> i) & 1;
+			i64[i] = (bits >> i) & 1;
+			ones += (bits >> i) & 1;
+		}
+		sort_network_i32(i32, 16);
+		sort_network_i64(i64, 16);
+		for (size_t i = 0; i < 16; i++) {
+			ASSERT(i32[i] == (i >= 16 - ones));
+			ASSERT(i64[i] == (int64_t)(i >= 16 - ones));
+		}
+	}
+
+	TEST_END("Sort Network");
+}
+
+typedef struct {
+	uint32_t key;
+	uint32_t seq;
+} FileRecord;
+
+static int compare_file_record(const void *a, const void *b) {
+	const FileRecord *ra = a;
+	const FileRecord *rb = b;
+	return (ra->key > rb->key) - (ra->key < rb->key);
+}
+
+static void check_external_sort(size_t count, size_t memory_limit) {
+	const char *input  = "external_sort_input.bin";
+	const char *output = "external_sort_output.bin";
+	FileRecord *records = malloc((count ? count : 1) * sizeof(FileRecord));
+
+	for (size_t i = 0; i < count; i++) {
+		records[i].key = rand() % 1000;
+		records[i].seq = i;
+	}
+	FILE *file = fopen(input, "wb");
+	ASSERT(file);
+	ASSERT(fwrite(records, sizeof(FileRecord), count, file) == count);
+	fclose(file);
+
+	ASSERT(external_sort(input, output, sizeof(FileRecord), compare_file_record, memory_limit, NULL) == 0);
+
+	file = fopen(output, "rb");
+	ASSERT(file);
+	ASSERT(fread(records, sizeof(FileRecord), count, file) == count);
+	ASSERT(fgetc(file) == EOF);
+	fclose(file);
+	for (size_t i = 1; i < count; i++) {
+		ASSERT(records[i - 1].key <= records[i].key);
+		if (records[i - 1].key == records[i].key)
+			ASSERT(records[i - 1].seq < records[i].seq);
+	}
+
+	remove(input);
+	remove(output);
+	free(records);
+}
+
+/* External sort tests */
+static void test_external_sort(void) {
+	TEST_START("External Sort");
+
+	// Fits in memory: sorted in one chunk, no run files
+	check_external_sort(0, 0);
+	check_external_sort(1000, 0);
+
+	// 64 KB budget: many runs, fan-in of 2, several merge passes
+	check_external_sort(50000, 64 * 1024);
+
+	// 4 MB budget: several runs, fan-in of 3
+	check_external_sort(1500000, 4 * 1024 * 1024);
+
+	// Bad inputs
+	ASSERT(external_sort("missing_input.bin", "out.bin", 8, compare_file_record, 0, NULL) != 0);
+	ASSERT(external_sort(NULL, "out.bin", 8, compare_file_record, 0, NULL) != 0);
+
+	TEST_END("External Sort");
+}
+
+/* Selection tests */
+static void test_selection(void) {
+	TEST_START("Selection");
+
+	size_t n	  = 100000;
+	int *original = random_ints(n, 5000);
+	int *expected = malloc(n * sizeof(int));
+	int *array	  = malloc(n * sizeof(int));
+	memcpy(expected, original, n * sizeof(int));
+	qsort(expected, n, sizeof(int), compare_int_safe);
+
+	// nth_element, including adversarial already-sorted input
+	size_t positions[] = {0, 1, 17, n / 2, n - 2, n - 1};
+	for (size_t p = 0; p < sizeof(positions) / sizeof(*positions); p++) {
+		size_t nth = positions[p];
+		memcpy(array, original, n * sizeof(int));
+		nth_element(array, n, nth, sizeof(int), compare_int_safe);
+		ASSERT(array[nth] == expected[nth]);
+		for (size_t i = 0; i < nth; i++)
+			ASSERT(array[i] <= array[nth]);
+		for (size_t i = nth + 1; i < n; i++)
+			ASSERT(array[i] >= array[nth]);
+
+		memcpy(array, expected, n * sizeof(int));
+		nth_element(array, n, nth, sizeof(int), compare_int_safe);
+		ASSERT(array[nth] == expected[nth]);
+	}
+
+	// partial_sort, through both the typed and the generic path
+	memcpy(array, original, n * sizeof(int));
+	partial_sort(array, n, 100, sizeof(int), compare_int);
+	ASSERT(memcmp(array, expected, 100 * sizeof(int)) == 0);
+	memcpy(array, original, n * sizeof(int));
+	partial_sort(array, n, 1000, sizeof(int), compare_int_safe);
+	ASSERT(memcmp(array, expected, 1000 * sizeof(int)) == 0);
+	memcpy(array, original, n * sizeof(int));
+	partial_sort(array, n, n + 5, sizeof(int), compare_int_safe);
+	ASSERT(memcmp(array, expected, n * sizeof(int)) == 0);
+
+	// Streaming top-k keeps the greatest elements
+	TopK topk;
+	int best[100];
+	ASSERT(topk_init(&topk, 100, sizeof(int), compare_int_safe));
+	for (size_t i = 0; i < n; i++)
+		topk_push(&topk, &original[i]);
+	ASSERT(topk_size(&topk) == 100);
+	ASSERT(topk_sorted(&topk, best) == 100);
+	for (size_t i = 0; i < 100; i++)
+		ASSERT(best[i] == expected[n - 1 - i]);
+
+	topk_clear(&topk);
+	ASSERT(topk_size(&topk) == 0);
+	int small[] = {3, 1, 2};
+	for (size_t i = 0; i < 3; i++)
+		ASSERT(topk_push(&topk, &small[i]));
+	ASSERT(topk_sorted(&topk, best) == 3);
+	ASSERT(best[0] == 3 && best[1] == 2 && best[2] == 1);
+	topk_destroy(&topk);
+
+	free(original);
+	free(expected);
+	free(array);
+
+	TEST_END("Selection");
+}
+
+int main(void) {
+	srand(42);
+	test_parallel_sort();
+	test_typed_sort();
+	test_sort_network();
+	test_selection();
+	test_external_sort();
+
+	printf("\nAll sort tests passed!\n");
+	return 0;
+}
@@ -6,16 +6,28 @@
 /*   By: vvaucoul <vvaucoul@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/01/31 12:25:51 by vvaucoul          #+#    #+#             */
-/*   Updated: 2025/01/31 12:32:09 by vvaucoul         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:00:00 by vvaucoul         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <locale.h>
+#include <math.h>
 #include <hypercore.h>
+#include <lib/strings/aho_corasick.h>
+#include <lib/strings/string_builder.h>
+#include <lib/strings/string_intern.h>
+#include <lib/strings/string_replace.h>
+#include <lib/strings/string_search.h>
+#include <lib/strings/string_view.h>
 #include <lib/strings/strings.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 /* Test helper functions */
 #define TEST_START(name) printf("Testing %s...\n", name)
@@ -302,6 +314,776 @@ static void test_edge_cases(void) {
 	TEST_END("Edge Cases");
 }
 
+/* SIMD primitives against libc, at every dispatch level */
+static size_t ref_count(const char *str, char c) {
+	size_t n = 0;
+	for (; *str; str++)
+		n += (*str == c);
+	return n;
+}
+
+static void check_primitives(const char *s, const char *other) {
+	ASSERT(str_len(s) == strlen(s));
+	ASSERT(str_chr(s, 'x') == strchr(s, 'x'));
+	ASSERT(str_chr(s, 'z') == strchr(s, 'z'));
+	ASSERT(str_chr(s, '\0') == strchr(s, '\0'));
+	ASSERT((size_t)str_count_char(s, 'x') == ref_count(s, 'x'));
+	ASSERT(str_span(s, "abcdefghijklmnopqrstuvwxy") == strspn(s, "abcdefghijklmnopqrstuvwxy"));
+	ASSERT(str_span(s, "ab") == strspn(s, "ab"));
+	int a = str_cmp(s, other), b = strcmp(s, other);
+	ASSERT((a < 0) == (b < 0) && (a > 0) == (b > 0));
+	a = str_cmp(other, s), b = strcmp(other, s);
+	ASSERT((a < 0) == (b < 0) && (a > 0) == (b > 0));
+}
+
+static void test_simd_primitives(void) {
+	TEST_START("SIMD Primitives");
+
+	StrSimdLevel best = str_simd_level();
+	long page		  = sysconf(_SC_PAGESIZE);
+	char *map		  = mmap(NULL, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ASSERT(map != MAP_FAILED);
+	ASSERT(mprotect(map + page, page, PROT_NONE) == 0);
+
+	for (int level = STR_SIMD_SWAR; level <= (int)best; level++) {
+		ASSERT(str_simd_set_level((StrSimdLevel)level) == (StrSimdLevel)level);
+		char buf[320], other[320];
+		for (size_t align = 0; align < 64; align++) {
+			for (size_t len = 0; len < 200; len += (len < 70) ? 1 : 13) {
+				char *s = buf + align;
+				for (size_t i = 0; i < len; i++)
+					s[i] = "abxab"[(i * 7 + align) % 5];
+				s[len] = '\0';
+				memcpy(other, s, len + 1);
+				check_primitives(s, other);
+				if (len) {
+					other[len / 2]++;
+					check_primitives(s, other);
+					other[len - 1] = '\xff';
+					check_primitives(s, other);
+				}
+			}
+		}
+		// Strings ending on the last byte before an unmapped page
+		for (size_t len = 0; len < 100; len++) {
+			char *s = map + page - len - 1;
+			memset(s, 'a', len);
+			s[len] = '\0';
+			check_primitives(s, s);
+			check_primitives(s, s + len / 2);
+			check_primitives(map + page - 1, s);
+		}
+	}
+	str_simd_set_level(best);
+	munmap(map, page * 2);
+
+	TEST_END("SIMD Primitives");
+}
+
+/* Substring search engine against a naive reference */
+static const char *naive_memstr(const char *h, size_t hl, const char *n, size_t nl) {
+	for (size_t i = 0; i + nl <= hl; i++)
+		if (memcmp(h + i, n, nl) == 0)
+			return h + i;
+	return NULL;
+}
+
+static void test_substring_search(void) {
+	TEST_START("Substring Search");
+
+	static const size_t needle_lens[] = {0, 1, 2, 3, 5, 16, 31, 32, 33, 64, 255, 256, 257, 300, 700};
+	static char hay[4096];
+	char needle[800];
+	StrSimdLevel best = str_simd_level();
+	unsigned seed	  = 12345;
+
+	for (int level = STR_SIMD_SWAR; level <= (int)best; level++) {
+		str_simd_set_level((StrSimdLevel)level);
+		for (int round = 0; round < 40; round++) {
+			// Tiny alphabets make near-misses and periodic needles common
+			int alphabet = 2 + round % 3;
+			for (size_t i = 0; i < sizeof(hay); i++) {
+				seed   = seed * 1103515245 + 12345;
+				hay[i] = 'a' + (seed >> 16) % alphabet;
+			}
+			for (size_t k = 0; k < sizeof(needle_lens) / sizeof(*needle_lens); k++) {
+				size_t nl = needle_lens[k];
+				seed	  = seed * 1103515245 + 12345;
+				if (round % 2) {
+					// Take the needle from the haystack so it occurs
+					memcpy(needle, hay + (seed >> 8) % (sizeof(hay) - nl), nl);
+				} else {
+					for (size_t i = 0; i < nl; i++)
+						needle[i] = (i % 7 == 6) ? 'b' : 'a';
+				}
+				for (size_t hl = 0; hl <= sizeof(hay); hl += 517)
+					ASSERT(str_memstr(hay, hl, needle, nl) == naive_memstr(hay, hl, needle, nl));
+				ASSERT(str_memstr(hay, sizeof(hay), needle, nl) ==
+					   naive_memstr(hay, sizeof(hay), needle, nl));
+			}
+		}
+	}
+	str_simd_set_level(best);
+
+	// Searcher reuse across haystacks
+	StrSearcher searcher;
+	str_searcher_init(&searcher, "needle", 6);
+	ASSERT(str_searcher_find(&searcher, "haystack with a needle", 22) != NULL);
+	ASSERT(str_searcher_find(&searcher, "no match here", 13) == NULL);
+	ASSERT(str_searcher_find(&searcher, "needl", 5) == NULL);
+
+	// Callers built on the engine
+	ASSERT(str_str("aaab", "aab") != NULL && str_equals(str_str("aaab", "aab"), "aab"));
+	ASSERT(str_str("abc", "abcd") == NULL);
+	// Matches on either side of str_str's block boundaries
+	char *long_hay = malloc(8192);
+	ASSERT(long_hay != NULL);
+	const size_t match_at[] = {0, 200, 254, 255, 256, 700, 767, 768, 1790, 4000, 8000};
+	for (size_t m = 0; m < sizeof(match_at) / sizeof(*match_at); m++) {
+		for (size_t nl = 1; nl <= 300; nl += 37) {
+			memset(long_hay, 'a', 8191);
+			long_hay[8191] = '\0';
+			for (size_t i = 0; i < nl && match_at[m] + i < 8191; i++)
+				long_hay[match_at[m] + i] = 'b';
+			char pattern[301];
+			memset(pattern, 'b', nl);
+			pattern[nl] = '\0';
+			char *expected = (match_at[m] + nl <= 8191) ? long_hay + match_at[m] : NULL;
+			ASSERT(str_str(long_hay, pattern) == expected);
+		}
+	}
+	free(long_hay);
+	ASSERT(str_equals(str_rstr("abababa", "aba"), "aba"));
+	ASSERT(str_rstr("abc", "x") == NULL);
+	char *replaced = str_replace("aaaa", "aa", "b");
+	ASSERT(str_equals(replaced, "bb"));
+	free(replaced);
+	replaced = str_replace("x--y--z", "--", "+++");
+	ASSERT(str_equals(replaced, "x+++y+++z"));
+	free(replaced);
+	char **split = str_split("a,b;c,d", ",;");
+	ASSERT(str_array_len(split) == 4);
+	ASSERT(str_equals(split[2], "c"));
+	str_array_free(split);
+
+	TEST_END("Substring Search");
+}
+
+/* Aho-Corasick against a brute-force enumeration of all occurrences */
+typedef struct {
+	size_t count;
+	size_t hash;
+	size_t last_end;
+	bool ordered;
+} MatchLog;
+
+static bool log_match(size_t pattern, size_t start, size_t end, void *ctx) {
+	MatchLog *log = ctx;
+	log->count++;
+	log->hash += (pattern + 1) * 1000003 + start * 31 + end;
+	log->ordered &= end >= log->last_end;
+	log->last_end = end;
+	return true;
+}
+
+static bool stop_first(size_t pattern, size_t start, size_t end, void *ctx) {
+	(void)pattern, (void)start, (void)end;
+	(*(size_t *)ctx)++;
+	return false;
+}
+
+static void test_multi_pattern(void) {
+	TEST_START("Multi-Pattern Search");
+
+	const char *keywords[] = {"he", "she", "his", "hers", "", "he", NULL};
+	AhoCorasick ac;
+	ASSERT(aho_corasick_init(&ac, keywords, NULL, 7));
+	MatchLog log = {0, 0, 0, true};
+	// "ushers": she@1, he@2 (twice, duplicate pattern), hers@2
+	ASSERT(aho_corasick_scan(&ac, "ushers", 6, log_match, &log) == 4);
+	ASSERT(log.ordered);
+	size_t calls = 0;
+	ASSERT(aho_corasick_scan(&ac, "ushers", 6, stop_first, &calls) == 1 && calls == 1);
+	ASSERT(aho_corasick_contains(&ac, "xxhisxx", 7));
+	ASSERT(!aho_corasick_contains(&ac, "xxhixx", 6));
+	aho_corasick_destroy(&ac);
+
+	unsigned seed = 777;
+	for (int round = 0; round < 30; round++) {
+		char text[2000];
+		char storage[200][12];
+		const char *patterns[200];
+		size_t lengths[200];
+		size_t count = 1 + round * 6;
+		for (size_t i = 0; i < sizeof(text); i++) {
+			seed	= seed * 1103515245 + 12345;
+			text[i] = "abcd\0\xff"[(seed >> 16) % 6];
+		}
+		for (size_t p = 0; p < count; p++) {
+			seed	   = seed * 1103515245 + 12345;
+			lengths[p] = 1 + (seed >> 16) % 8;
+			for (size_t j = 0; j < lengths[p]; j++) {
+				seed		  = seed * 1103515245 + 12345;
+				storage[p][j] = "abcd\0\xff"[(seed >> 16) % ((round % 2) ? 3 : 6)];
+			}
+			patterns[p] = storage[p];
+		}
+		MatchLog expected = {0, 0, 0, true};
+		for (size_t end = 1; end <= sizeof(text); end++)
+			for (size_t p = 0; p < count; p++)
+				if (lengths[p] <= end && memcmp(text + end - lengths[p], patterns[p], lengths[p]) == 0)
+					log_match(p, end - lengths[p], end, &expected);
+
+		ASSERT(aho_corasick_init(&ac, patterns, lengths, count));
+		MatchLog got = {0, 0, 0, true};
+		ASSERT(aho_corasick_scan(&ac, text, sizeof(text), log_match, &got) == expected.count);
+		ASSERT(got.count == expected.count && got.hash == expected.hash && got.ordered);
+		ASSERT(aho_corasick_contains(&ac, text, sizeof(text)) == (expected.count > 0));
+		aho_corasick_destroy(&ac);
+	}
+
+	TEST_END("Multi-Pattern Search");
+}
+
+/* String builder */
+static void test_string_builder(void) {
+	TEST_START("String Builder");
+
+	StrBuilder sb;
+	ASSERT(str_builder_init(&sb, 0));
+	ASSERT(str_equals(str_builder_cstr(&sb), ""));
+
+	// Many small appends stay linear and keep the terminator in place
+	for (int i = 0; i < 10000; i++)
+		ASSERT(str_builder_append_char(&sb, 'a' + i % 26));
+	ASSERT(str_builder_len(&sb) == 10000);
+	ASSERT(str_len(str_builder_cstr(&sb)) == 10000);
+	ASSERT(sb.capacity >= sb.len && sb.capacity < 4 * sb.len);
+	str_builder_clear(&sb);
+
+	ASSERT(str_builder_append(&sb, "  Hello"));
+	ASSERT(str_builder_appendf(&sb, ", %s #%d%c", "world", 42, '!'));
+	ASSERT(str_builder_append_repeat(&sb, ' ', 3));
+	ASSERT(str_builder_equals(&sb, "  Hello, world #42!   "));
+	str_builder_trim(&sb);
+	ASSERT(str_builder_equals(&sb, "Hello, world #42!"));
+	ASSERT(str_builder_starts_with(&sb, "Hello") && str_builder_ends_with(&sb, "42!"));
+	ASSERT(str_builder_find(&sb, "world", 0) == 7);
+	ASSERT(str_builder_find(&sb, "world", 8) == STR_BUILDER_NPOS);
+
+	// Long formatted output takes the grow-and-retry path
+	char big[300];
+	memset(big, 'x', sizeof(big) - 1);
+	big[sizeof(big) - 1] = '\0';
+	ASSERT(str_builder_appendf(&sb, "[%s]", big));
+	ASSERT(sb.len == 17 + 301 && sb.data[sb.len - 1] == ']');
+	str_builder_truncate(&sb, 17);
+
+	ASSERT(str_builder_replace(&sb, "o", "0"));
+	ASSERT(str_builder_equals(&sb, "Hell0, w0rld #42!"));
+	ASSERT(str_builder_replace(&sb, "l", ""));
+	ASSERT(str_builder_equals(&sb, "He0, w0rd #42!"));
+	ASSERT(str_builder_replace(&sb, "0", "<o>"));
+	ASSERT(str_builder_equals(&sb, "He<o>, w<o>rd #42!"));
+
+	ASSERT(str_builder_insert(&sb, 0, ">> "));
+	str_builder_erase(&sb, 3, 2);
+	ASSERT(str_builder_equals(&sb, ">> <o>, w<o>rd #42!"));
+	str_builder_upper(&sb);
+	ASSERT(str_builder_equals(&sb, ">> <O>, W<O>RD #42!"));
+	str_builder_clear(&sb);
+	str_builder_append(&sb, "hELLO");
+	str_builder_capitalize(&sb);
+	ASSERT(str_builder_equals(&sb, "Hello"));
+	str_builder_reverse(&sb);
+	ASSERT(str_builder_equals(&sb, "olleH"));
+
+	const char *parts[] = {"a", "b", "c", NULL};
+	str_builder_clear(&sb);
+	ASSERT(str_builder_join(&sb, parts, ", "));
+	ASSERT(str_builder_equals(&sb, "a, b, c"));
+
+	// Detached buffers belong to the caller and the builder starts over
+	char *owned = str_builder_detach(&sb);
+	ASSERT(str_equals(owned, "a, b, c"));
+	free(owned);
+	ASSERT(sb.data == NULL && str_builder_len(&sb) == 0);
+	owned = str_builder_detach(&sb);
+	ASSERT(owned && str_equals(owned, ""));
+	free(owned);
+
+	ASSERT(str_builder_from(&sb, "embedded"));
+	ASSERT(str_builder_append_len(&sb, "\0nul", 4));
+	ASSERT(str_builder_len(&sb) == 12 && str_builder_find(&sb, "nul", 0) == 9);
+	ASSERT(str_builder_shrink(&sb) && sb.capacity == sb.len);
+	str_builder_destroy(&sb);
+
+	// Sources inside the builder survive the buffer moving on growth
+	ASSERT(str_builder_from(&sb, "abcdef"));
+	ASSERT(str_builder_shrink(&sb));
+	ASSERT(str_builder_append_len(&sb, sb.data, sb.len));
+	ASSERT(str_builder_equals(&sb, "abcdefabcdef"));
+	ASSERT(str_builder_shrink(&sb));
+	ASSERT(str_builder_insert(&sb, 0, sb.data + 6));
+	ASSERT(str_builder_equals(&sb, "abcdefabcdefabcdef"));
+	ASSERT(str_builder_shrink(&sb));
+	ASSERT(str_builder_insert(&sb, 3, sb.data + 15));
+	ASSERT(str_builder_equals(&sb, "abcdefdefabcdefabcdef"));
+	ASSERT(str_builder_shrink(&sb));
+	ASSERT(str_builder_insert(&sb, 4, sb.data + 1));
+	ASSERT(str_builder_equals(&sb, "abcdbcdefdefabcdefabcdefefdefabcdefabcdef"));
+	str_builder_destroy(&sb);
+
+	TEST_END("String Builder");
+}
+
+/* String views and non-allocating iterators */
+static void test_string_view(void) {
+	TEST_START("String View");
+
+	const char *text = "  id,name,,score  ";
+	StrView v		 = str_view(text);
+	ASSERT(v.len == 18 && v.data == text);
+	ASSERT(str_view_equals(str_view_trim(v), str_view("id,name,,score")));
+	ASSERT(str_view_trim(str_view("   ")).len == 0);
+	ASSERT(str_view_equals(str_view_sub(v, 2, 2), str_view("id")));
+	ASSERT(str_view_sub(v, 100, 5).len == 0);
+	ASSERT(str_view_find(v, str_view("name")) == 5);
+	ASSERT(str_view_find(v, str_view("nope")) == STR_VIEW_NPOS);
+	ASSERT(str_view_find_char(v, ',') == 4);
+	ASSERT(str_view_starts_with(str_view_trim(v), str_view("id,")));
+	ASSERT(str_view_ends_with(str_view_trim(v), str_view("score")));
+	ASSERT(str_view_cmp(str_view("ab"), str_view("abc")) < 0);
+	ASSERT(str_view_cmp(str_view("abd"), str_view("abc")) > 0);
+	ASSERT(str_view_cmp(str_view(NULL), str_view("")) == 0);
+
+	// Exact delimiter: empty fields are kept and views alias the input
+	const char *expected[] = {"id", "name", "", "score"};
+	StrSplitIter split;
+	StrView field;
+	size_t n = 0;
+	str_split_iter_init(&split, str_view_trim(v), str_view(","));
+	while (str_split_iter_next(&split, &field)) {
+		ASSERT(n < 4 && str_view_equals(field, str_view(expected[n])));
+		ASSERT(field.data >= text && field.data + field.len <= text + v.len);
+		n++;
+	}
+	ASSERT(n == 4);
+
+	str_split_iter_init(&split, str_view("a::b::"), str_view("::"));
+	ASSERT(str_split_iter_next(&split, &field) && str_view_equals(field, str_view("a")));
+	ASSERT(str_split_iter_next(&split, &field) && str_view_equals(field, str_view("b")));
+	ASSERT(str_split_iter_next(&split, &field) && field.len == 0);
+	ASSERT(!str_split_iter_next(&split, &field));
+	str_split_iter_init(&split, str_view(""), str_view(","));
+	ASSERT(str_split_iter_next(&split, &field) && field.len == 0);
+	ASSERT(!str_split_iter_next(&split, &field));
+
+	// Delimiter set: runs collapse and empty tokens are skipped
+	StrTokenIter tok;
+	char buf[8];
+	n = 0;
+	str_token_iter_init(&tok, str_view(" a  bc\t\td \n"), " \t\n");
+	while (str_token_iter_next(&tok, &field)) {
+		ASSERT(str_view_copy(field, buf, sizeof(buf)) == field.len);
+		ASSERT(str_equals(buf, (const char *[]){"a", "bc", "d"}[n]));
+		n++;
+	}
+	ASSERT(n == 3);
+
+	ASSERT(str_view_copy(str_view("truncated"), buf, 4) == 9 && str_equals(buf, "tru"));
+	char *dup = str_view_dup(str_view_sub(str_view("hello world"), 6, 5));
+	ASSERT(str_equals(dup, "world"));
+	free(dup);
+
+	char **split_all = str_split(",,x,,y,", ",");
+	ASSERT(str_array_len(split_all) == 2 && str_equals(split_all[1], "y"));
+	str_array_free(split_all);
+	split_all = str_split("", ",");
+	ASSERT(split_all && split_all[0] == NULL);
+	str_array_free(split_all);
+
+	TEST_END("String View");
+}
+
+/* Numeric parsing: consumed lengths, overflow, and strtod agreement */
+static void check_double(const char *text) {
+	char *end;
+	errno			   = 0;
+	double expected	   = strtod(text, &end);
+	int expected_errno = errno;
+	double got		   = -1.0;
+	errno			   = 0;
+	size_t used		   = str_parse_double(text, strlen(text), &got);
+	ASSERT(used == (size_t)(end - text));
+	ASSERT(errno == expected_errno);
+	if (used)
+		ASSERT(memcmp(&got, &expected, sizeof(double)) == 0 || (isnan(got) && isnan(expected)));
+}
+
+static void test_number_parsing(void) {
+	TEST_START("Number Parsing");
+
+	int iv			= 7;
+	long lv			= 0;
+	int64_t i64		= 0;
+	uint64_t u64	= 0;
+	const char *big = "123456789012345678901234";
+
+	ASSERT(str_parse_int("42,rest", 7, &iv) == 2 && iv == 42);
+	ASSERT(str_parse_int("-0012", 5, &iv) == 5 && iv == -12);
+	iv = 7;
+	ASSERT(str_parse_int("x1", 2, &iv) == 0 && iv == 7);
+	ASSERT(str_parse_int("-", 1, &iv) == 0 && iv == 7);
+	ASSERT(str_parse_int("123", 2, &iv) == 2 && iv == 12);
+	errno = 0;
+	ASSERT(str_parse_int("2147483647", 10, &iv) == 10 && iv == 2147483647 && errno == 0);
+	ASSERT(str_parse_int("-2147483648", 11, &iv) == 11 && iv == (-2147483647 - 1) && errno == 0);
+	ASSERT(str_parse_int("2147483648", 10, &iv) == 10 && iv == 2147483647 && errno == ERANGE);
+	errno = 0;
+	ASSERT(str_parse_i64("-9223372036854775808", 20, &i64) == 20 && i64 == INT64_MIN && errno == 0);
+	ASSERT(str_parse_i64(big, strlen(big), &i64) == 24 && i64 == INT64_MAX && errno == ERANGE);
+	errno = 0;
+	ASSERT(str_parse_u64("18446744073709551615", 20, &u64) == 20 && u64 == UINT64_MAX && errno == 0);
+	ASSERT(str_parse_u64("18446744073709551616", 20, &u64) == 20 && u64 == UINT64_MAX && errno == ERANGE);
+	ASSERT(str_parse_u64("-1", 2, &u64) == 0);
+	ASSERT(str_parse_long("0000000000000000000000012345678", 31, &lv) == 31 && lv == 12345678);
+	ASSERT(str_to_int("99999999999") == 2147483647);
+	ASSERT(str_to_long("+17") == 17);
+
+	const char *cases[] = {"0", "-0", "1e23", "2.2250738585072011e-308", "4.9e-324", "2.4703282292062328e-324",
+						   "1.7976931348623157e308", "1.7976931348623159e308", "1e-400", "1e400", "4e-320", "0e-400", "9007199254740993",
+						   "1.00000000000000011102230246251565404236316680908203125", "0.1", "1e", "1e+", "-.5",
+						   ".5e3", "5.", "inf", "-Infinity", "nan", "+", ".", "e5", "123456789012345678901234567890"};
+	for (size_t i = 0; i < sizeof(cases) / sizeof(*cases); i++)
+		check_double(cases[i]);
+
+	unsigned seed = 4242;
+	char text[96];
+	for (int i = 0; i < 200000; i++) {
+		uint64_t bits = 0;
+		double d;
+		for (int k = 0; k < 4; k++) {
+			seed = seed * 1103515245 + 12345;
+			bits = (bits << 16) | ((seed >> 8) & 0xFFFF);
+		}
+		memcpy(&d, &bits, sizeof(d));
+		if (isnan(d))
+			continue;
+		snprintf(text, sizeof(text), "%.*g", 1 + i % 17, d);
+		check_double(text);
+		if (i % 4 == 0) {
+			// Long mantissas take the truncated path
+			snprintf(text, sizeof(text), "%.40e", d);
+			check_double(text);
+		}
+	}
+	ASSERT(str_to_double("1.5e3") == 1500.0);
+	ASSERT(str_to_double("0.1") == 0.1);
+
+	// Just above a halfway point: takes the strtod fallback, which must not
+	// follow a ',' decimal point locale
+	const char *above = "1.00000000000000011102230246251565404236316680908203126";
+	double in_c		  = 0.0;
+	double localized  = 0.0;
+	str_parse_double(above, strlen(above), &in_c);
+	ASSERT(in_c == nextafter(1.0, 2.0));
+	if (setlocale(LC_NUMERIC, "de_DE.UTF-8") != NULL || setlocale(LC_NUMERIC, "de_DE") != NULL) {
+		ASSERT(str_parse_double(above, strlen(above), &localized) == strlen(above));
+		ASSERT(localized == in_c);
+		setlocale(LC_NUMERIC, "C");
+	}
+
+	TEST_END("Number Parsing");
+}
+
+/* Number formatting: exact integers, round-tripping doubles */
+static void test_number_formatting(void) {
+	TEST_START("Number Formatting");
+
+	char buf[STR_DOUBLE_BUFSIZE];
+	char ref[32];
+
+	ASSERT(str_format_int(buf, 0) == 1 && str_equals(buf, "0"));
+	ASSERT(str_format_int(buf, INT_MIN) == 11 && str_equals(buf, "-2147483648"));
+	ASSERT(str_format_i64(buf, INT64_MIN) == 20 && str_equals(buf, "-9223372036854775808"));
+	ASSERT(str_format_u64(buf, UINT64_MAX) == 20 && str_equals(buf, "18446744073709551615"));
+	for (int64_t v = 1;; v *= 10) {
+		for (int64_t d = -1; d <= 1; d++) {
+			snprintf(ref, sizeof(ref), "%lld", (long long)(v + d));
+			ASSERT(str_format_i64(buf, v + d) == strlen(ref) && str_equals(buf, ref));
+		}
+		if (v > INT64_MAX / 10)
+			break;
+	}
+	char *s = int_to_str(INT_MIN);
+	ASSERT(str_equals(s, "-2147483648"));
+	free(s);
+	s = long_to_str(-42);
+	ASSERT(str_equals(s, "-42"));
+	free(s);
+	s = double_to_str(1e300, 2);
+	ASSERT(s && str_len(s) == 304);
+	free(s);
+
+	const struct {
+		double value;
+		const char *text;
+	} cases[] = {
+		{0.1, "0.1"},
+		{-0.0, "-0"},
+		{100, "100"},
+		{1e21, "1e21"},
+		{1e20, "100000000000000000000"},
+		{1.5e-7, "1.5e-7"},
+		{0.000001, "0.000001"},
+		{-42.5, "-42.5"},
+		{5e-324, "5e-324"},
+		{1.7976931348623157e308, "1.7976931348623157e308"},
+		{INFINITY, "inf"},
+		{-INFINITY, "-inf"},
+	};
+	for (size_t i = 0; i < sizeof(cases) / sizeof(*cases); i++) {
+		ASSERT(str_format_double(buf, cases[i].value) == strlen(cases[i].text));
+		ASSERT(str_equals(buf, cases[i].text));
+	}
+	ASSERT(str_format_double(buf, NAN) == 3 && str_equals(buf, "nan"));
+
+	// Every finite double must parse back to itself
+	unsigned seed = 99;
+	for (int i = 0; i < 200000; i++) {
+		uint64_t bits = 0;
+		double d, back;
+		for (int k = 0; k < 4; k++) {
+			seed = seed * 1103515245 + 12345;
+			bits = (bits << 16) | ((seed >> 8) & 0xFFFF);
+		}
+		memcpy(&d, &bits, sizeof(d));
+		if (isnan(d))
+			continue;
+		size_t len = str_format_double(buf, d);
+		ASSERT(len == strlen(buf) && len < STR_DOUBLE_BUFSIZE);
+		ASSERT(str_parse_double(buf, len, &back) == len);
+		ASSERT(memcmp(&back, &d, sizeof(d)) == 0);
+	}
+
+	StrBuilder sb;
+	ASSERT(str_builder_init(&sb, 0));
+	ASSERT(str_builder_append_i64(&sb, -7) && str_builder_append_char(&sb, ','));
+	ASSERT(str_builder_append_u64(&sb, 8) && str_builder_append_char(&sb, ','));
+	ASSERT(str_builder_append_double(&sb, 0.25));
+	ASSERT(str_builder_equals(&sb, "-7,8,0.25"));
+	str_builder_destroy(&sb);
+
+	TEST_END("Number Formatting");
+}
+
+/* Interning: one canonical copy per distinct string */
+static void test_string_intern(void) {
+	TEST_START("String Interning");
+
+	StrInternPool pool;
+	ASSERT(str_intern_init(&pool, 0));
+
+	char a[] = "service.requests";
+	char b[] = "service.requests";
+	const char *ia = str_intern(&pool, a);
+	const char *ib = str_intern(&pool, b);
+	ASSERT(ia && ia == ib && ia != a && str_equals(ia, a));
+	ASSERT(str_intern(&pool, "service.errors") != ia);
+	ASSERT(str_intern_count(&pool) == 2);
+	ASSERT(str_intern_id(&pool, b) == 0 && str_intern_id(&pool, "service.errors") == 1);
+	ASSERT(str_intern_string(&pool, 1) == str_intern_lookup(&pool, "service.errors"));
+	ASSERT(str_intern_string(&pool, 2) == NULL);
+
+	// Length-delimited input matches the NUL-terminated form
+	ASSERT(str_intern_len(&pool, "service.requests.total", 16) == ia);
+	ASSERT(str_intern_len(&pool, "", 0) == str_intern(&pool, ""));
+	ASSERT(str_intern_len(&pool, "service\0x", 9) == NULL);
+	ASSERT(str_intern_lookup(&pool, "missing") == NULL);
+	ASSERT(str_intern_lookup_id(&pool, "missing") == STR_INTERN_NONE);
+	ASSERT(str_intern_count(&pool) == 3);
+	size_t bytes = pool.bytes;
+	ASSERT(str_intern_len(&pool, "service.errors!", 14) == str_intern_string(&pool, 1));
+	ASSERT(pool.bytes == bytes);
+
+	// Pointers stay stable while the table and arena grow
+	char name[32];
+	const char *first[5000];
+	for (int i = 0; i < 5000; i++) {
+		snprintf(name, sizeof(name), "label_%d", i);
+		first[i] = str_intern(&pool, name);
+		ASSERT(first[i] && str_equals(first[i], name));
+	}
+	for (int i = 0; i < 5000; i++) {
+		snprintf(name, sizeof(name), "label_%d", i);
+		ASSERT(str_intern(&pool, name) == first[i]);
+		ASSERT(str_intern_string(&pool, str_intern_lookup_id(&pool, name)) == first[i]);
+	}
+	ASSERT(str_intern_count(&pool) == 5003);
+
+	str_intern_destroy(&pool);
+	ASSERT(str_intern_count(&pool) == 0);
+
+	TEST_END("String Interning");
+}
+
+/* Replacement without per-call allocation */
+static void test_replace_variants(void) {
+	TEST_START("Replace Variants");
+
+	char buf[64];
+	ASSERT(str_replace_into(buf, sizeof(buf), "a-b-c", "-", "+=") == 7 && str_equals(buf, "a+=b+=c"));
+	ASSERT(str_replace_into(buf, 5, "a-b-c", "-", "+=") == 7 && str_equals(buf, "a+=b"));
+	ASSERT(str_replace_into(NULL, 0, "a-b-c", "-", "") == 3);
+	ASSERT(str_replace_into(buf, sizeof(buf), "abc", "", "x") == 3 && str_equals(buf, "abc"));
+
+	// In place when the replacement does not grow
+	char text[] = "one, two, three";
+	ASSERT(str_replace_into(text, sizeof(text), text, ", ", ";") == 13);
+	ASSERT(str_equals(text, "one;two;three"));
+
+	StrBuilder sb;
+	ASSERT(str_builder_init(&sb, 0));
+	ASSERT(str_builder_append(&sb, ">"));
+	ASSERT(str_builder_append_replace(&sb, "x.y.z", ".", "::"));
+	ASSERT(str_builder_equals(&sb, ">x::y::z"));
+
+	// Batch: single pass, longest match first, output never rescanned
+	const StrReplacePair pairs[] = {
+		{"{{name}}", "Ada"},
+		{"{{n}}", "{{name}}"},
+		{"{{name}}s", "many"},
+		{"&", "&amp;"},
+		{"<", "&lt;"},
+		{"", "ignored"},
+	};
+	StrReplacer replacer;
+	ASSERT(str_replacer_init(&replacer, pairs, 6));
+	const char *tmpl = "Hi {{name}}, {{n}} & {{name}}s <3 {{nam";
+	const char *want = "Hi Ada, {{name}} &amp; many &lt;3 {{nam";
+	str_builder_clear(&sb);
+	ASSERT(str_replacer_apply(&replacer, tmpl, strlen(tmpl), &sb));
+	ASSERT(str_builder_equals(&sb, want));
+	ASSERT(str_replacer_apply_into(&replacer, tmpl, strlen(tmpl), buf, sizeof(buf)) == strlen(want));
+	ASSERT(str_equals(buf, want));
+	ASSERT(str_replacer_apply_into(&replacer, tmpl, strlen(tmpl), buf, 10) == strlen(want));
+	ASSERT(str_equals(buf, "Hi Ada, {"));
+	str_replacer_destroy(&replacer);
+
+	// A single leading byte takes the memchr path
+	const StrReplacePair braces[] = {{"{a}", "1"}, {"{bb}", "22"}};
+	char *many = str_replace_many("{a}{bb}{c}{a", braces, 2);
+	ASSERT(str_equals(many, "122{c}{a"));
+	free(many);
+
+	str_builder_destroy(&sb);
+
+	TEST_END("Replace Variants");
+}
+
+/* ASCII case and class kernels against byte-wise references */
+static int ref_case_cmp(const char *s1, const char *s2) {
+	unsigned char c1, c2;
+	do {
+		c1 = (*s1 >= 'A' && *s1 <= 'Z') ? *s1 + 32 : *s1;
+		c2 = (*s2 >= 'A' && *s2 <= 'Z') ? *s2 + 32 : *s2;
+		s1++;
+		s2++;
+	} while (c1 && c1 == c2);
+	return c1 - c2;
+}
+
+static bool ref_all(const char *s, size_t len, const char *lo, const char *hi) {
+	for (size_t i = 0; i < len; i++) {
+		bool in = false;
+		for (size_t r = 0; lo[r]; r++)
+			in |= (s[i] >= lo[r] && s[i] <= hi[r]);
+		if (!in)
+			return false;
+	}
+	return true;
+}
+
+static void check_ascii(char *s, size_t len) {
+	char lower[128], upper[128], copy[128];
+
+	for (size_t i = 0; i < len; i++) {
+		lower[i] = (s[i] >= 'A' && s[i] <= 'Z') ? s[i] + 32 : s[i];
+		upper[i] = (s[i] >= 'a' && s[i] <= 'z') ? s[i] - 32 : s[i];
+	}
+	str_mem_lower(copy, s, len);
+	ASSERT(memcmp(copy, lower, len) == 0);
+	str_mem_upper(copy, s, len);
+	ASSERT(memcmp(copy, upper, len) == 0);
+	ASSERT(str_mem_case_equals(copy, s, len));
+	ASSERT(str_mem_case_hash(copy, len) == str_mem_case_hash(lower, len));
+	if (len) {
+		copy[len - 1] ^= 0x01;
+		ASSERT(!str_mem_case_equals(copy, s, len));
+	}
+
+	s[len] = '\0';
+	ASSERT(str_is_alpha(s) == ref_all(s, len, "Aa", "Zz"));
+	ASSERT(str_is_digit(s) == ref_all(s, len, "0", "9"));
+	ASSERT(str_is_alnum(s) == ref_all(s, len, "Aa0", "Zz9"));
+	ASSERT(str_is_space(s) == ref_all(s, len, "\t ", "\r "));
+	ASSERT(str_is_upper(s) == ref_all(s, len, "A", "Z"));
+	ASSERT(str_is_lower(s) == ref_all(s, len, "a", "z"));
+
+	memcpy(copy, upper, len);
+	copy[len] = '\0';
+	ASSERT(str_case_cmp(s, copy) == 0 && str_case_equals(copy, s));
+	if (len) {
+		copy[len / 2] = '\x7f';
+		ASSERT(str_case_cmp(s, copy) == ref_case_cmp(s, copy));
+		ASSERT(str_case_cmp(copy, s) == ref_case_cmp(copy, s));
+	}
+	memcpy(copy, s, len + 1);
+	ASSERT(str_upper(copy) == copy && memcmp(copy, upper, len) == 0 && !copy[len]);
+	ASSERT(str_lower(copy) == copy && memcmp(copy, lower, len) == 0 && !copy[len]);
+}
+
+static void test_ascii_case(void) {
+	TEST_START("ASCII Case and Classes");
+
+	StrSimdLevel best = str_simd_level();
+	const char *alphabets[] = {"aZ09 \t", "abcXYZ", "0123456789", " \t\n\r\v\f", "@[`{/:\x80\xff", "gH5@\x7f\xc3"};
+	unsigned seed = 7;
+
+	for (int level = STR_SIMD_SWAR; level <= (int)best; level++) {
+		str_simd_set_level((StrSimdLevel)level);
+		char buf[160];
+		for (size_t a = 0; a < sizeof(alphabets) / sizeof(*alphabets); a++) {
+			size_t n = strlen(alphabets[a]);
+			for (size_t len = 0; len < 100; len++) {
+				char *s = buf + (len % 32);
+				for (size_t i = 0; i < len; i++) {
+					seed = seed * 1103515245 + 12345;
+					s[i] = alphabets[a][(seed >> 16) % n];
+				}
+				check_ascii(s, len);
+				// One stray byte anywhere must flip the class checks
+				if (len && a < 4) {
+					s[(seed >> 8) % len] = '#';
+					check_ascii(s, len);
+				}
+			}
+		}
+	}
+	str_simd_set_level(best);
+
+	ASSERT(str_case_hash("Content-Length") == str_case_hash("content-length"));
+	ASSERT(str_case_hash("Content-Length") != str_case_hash("Content-Type"));
+	ASSERT(str_case_hash(NULL) == str_case_hash(""));
+	ASSERT(str_view_case_equals(str_view("HOST"), str_view("host")));
+	ASSERT(!str_view_case_equals(str_view("host"), str_view("hosts")));
+	ASSERT(!str_case_equals(NULL, "") && str_case_equals(NULL, NULL));
+	ASSERT(!str_is_alpha(NULL) && str_is_alpha(""));
+
+	TEST_END("ASCII Case and Classes");
+}
+
 /* Main test function */
 int main(void) {
 	printf("Starting String Library Tests\n");
@@ -317,6 +1099,16 @@ int main(void) {
 	test_memory_management();
 	test_null_handling();
 	test_edge_cases();
+	test_simd_primitives();
+	test_substring_search();
+	test_multi_pattern();
+	test_string_builder();
+	test_string_view();
+	test_number_parsing();
+	test_number_formatting();
+	test_string_intern();
+	test_replace_variants();
+	test_ascii_case();
 
 	printf("\nAll tests passed successfully!\n");
 	return 0;